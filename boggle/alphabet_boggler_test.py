@@ -0,0 +1,46 @@
+from cpp_boggle import Alphabet, AlphabetTrie14
+
+from boggle.dimensional_bogglers import AlphabetBogglers14
+
+JPA14 = "acdegilmnoprst"
+
+
+def test_alphabet():
+    a = Alphabet("aest")
+    assert a.size() == 4
+    assert a.code("a") == 0
+    assert a.code("t") == 3
+    assert a.code("z") == -1
+
+
+def test_alphabet_trie():
+    t = AlphabetTrie14.create_from_wordlist(
+        ["tea", "teas", "zeta", "eat"], Alphabet("aest")
+    )
+    # "zeta" is pruned
+    assert t.size() == 3
+    assert t.find_word_id("teas") == 1
+    assert t.find_word_id("zeta") == AlphabetTrie14.NOT_A_WORD
+
+    assert AlphabetTrie14.create_from_wordlist(["tea"], Alphabet(JPA14 + "bf")) is None
+
+
+def test_alphabet_boggler():
+    t = AlphabetTrie14.create_from_wordlist(
+        ["tea", "teas", "zeta", "eat"], Alphabet("aest")
+    )
+    b = AlphabetBogglers14[(2, 2)](t)
+    assert b.score("teas") == 3
+    # Letters outside the alphabet act as blocked cells.
+    assert b.score("zeta") == 2
+
+
+def test_jpa14_scores():
+    # These match Boggler on the full twl06 dictionary.
+    t = AlphabetTrie14.create_from_file("wordlists/twl06.txt", Alphabet(JPA14))
+    assert t.size() == 44220
+    b = AlphabetBogglers14[(3, 3)](t)
+    assert b.score("streaedlp") == 546
+
+    b = AlphabetBogglers14[(5, 5)](t)
+    assert b.score("sepesdsracietilmanesligdr") == 10759
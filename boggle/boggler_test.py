@@ -182,3 +182,50 @@ def test_multiboggle_score(get_trie, Boggler):
         )
         == q_bd_score
     )
+
+
+def test_score_with_attribution():
+    t = get_cpp_trie()
+    b = cpp_boggler(t, (4, 4))
+    for bd in ("perslatgsineters", "besbrrneeeehbteq"):
+        score, cell_scores, cell_words = b.score_with_attribution(bd)
+        assert score == b.score(bd)
+        assert len(cell_scores) == len(cell_words) == 16
+
+        # This should match the first path that find_words returns for each word.
+        expected_scores = [0] * 16
+        expected_words = [0] * 16
+        for path in b.find_words(bd, False):
+            points = SCORES[sum(2 if bd[cell] == "q" else 1 for cell in path)]
+            for cell in path:
+                expected_scores[cell] += points
+                expected_words[cell] += 1
+        assert cell_scores == expected_scores
+        assert cell_words == expected_words
+
+    assert b.score_with_attribution("abc")[0] == -1
+
+
+def test_score_pruned():
+    t = get_cpp_trie()
+    for dims, bds in (
+        ((2, 2), ("abcd", "qaqa", "tase")),
+        ((3, 3), ("abcdefghi", "streaedlp")),
+        ((4, 4), ("perslatgsineters", "besbrrneeeehbteq")),
+    ):
+        b = cpp_boggler(t, dims)
+        for bd in bds:
+            score = b.score(bd)
+            assert b.score_pruned(bd) == score
+            assert b.score_counting_visits(bd, prune=False)[0] == score
+            pruned_score, pruned_visits = b.score_counting_visits(bd, prune=True)
+            assert pruned_score == score
+            assert pruned_visits <= b.score_counting_visits(bd, prune=False)[1]
+
+    # On a 2x2 board, most prefixes are too long to finish.
+    b = cpp_boggler(t, (2, 2))
+    _, visits = b.score_counting_visits("tase", prune=False)
+    _, pruned_visits = b.score_counting_visits("tase", prune=True)
+    assert pruned_visits < visits
+    assert b.score_pruned("abc") == -1
+    assert b.score_counting_visits("abc", prune=True) == (-1, 0)
@@ -0,0 +1,31 @@
+from cpp_boggle import Trie
+
+from boggle.dimensional_bogglers import Bogglers, CorpusAnalyzers
+
+
+def test_corpus_stats():
+    t = Trie.create_from_file("wordlists/enable2k.txt")
+    boards = ["streaedlp", "abcdefghi", "streaedlp", "bad"]
+    stats = CorpusAnalyzers[(3, 3)](t).analyze(boards, num_threads=2)
+    assert stats.num_boards == 4
+    assert stats.num_invalid == 1
+    hits, paths = memoryview(stats.hits), memoryview(stats.paths)
+    assert hits.format == paths.format == "Q"
+    assert hits.readonly
+    assert len(hits) == len(paths) == t.size()
+
+    # Every word on a board counts once, however many ways it can be spelled.
+    b = Bogglers[(3, 3)](t)
+    num_words = sum(len(b.find_words(bd, False)) for bd in boards[:3])
+    assert sum(hits) == num_words
+
+    tea = t.find_word("tea")
+    # "tea" has two paths on streaedlp, one through each "e".
+    assert stats.hits[tea.word_id()] == 2
+    assert stats.paths[tea.word_id()] == 4
+    assert all(p >= h for h, p in zip(hits, paths))
+
+    # The result doesn't depend on the number of threads.
+    stats1 = CorpusAnalyzers[(3, 3)](t).analyze(boards, num_threads=1)
+    assert memoryview(stats1.hits) == hits
+    assert memoryview(stats1.paths) == paths
@@ -1,4 +1,11 @@
 from cpp_boggle import (
+    AlphabetBoggler22_14,
+    AlphabetBoggler23_14,
+    AlphabetBoggler33_14,
+    AlphabetBoggler34_14,
+    AlphabetBoggler44_14,
+    AlphabetBoggler45_14,
+    AlphabetBoggler55_14,
     Boggler22,
     Boggler23,
     Boggler33,
@@ -6,6 +13,55 @@ from cpp_boggle import (
     Boggler44,
     Boggler45,
     Boggler55,
+    CorpusAnalyzer22,
+    CorpusAnalyzer23,
+    CorpusAnalyzer33,
+    CorpusAnalyzer34,
+    CorpusAnalyzer44,
+    CorpusAnalyzer45,
+    CorpusAnalyzer55,
+    IterativeBoggler22,
+    IterativeBoggler23,
+    IterativeBoggler33,
+    IterativeBoggler34,
+    IterativeBoggler44,
+    IterativeBoggler45,
+    IterativeBoggler55,
+    LiveBoggler22,
+    LiveBoggler23,
+    LiveBoggler33,
+    LiveBoggler34,
+    LiveBoggler44,
+    LiveBoggler45,
+    LiveBoggler55,
+    MultiBoggler22,
+    MultiBoggler23,
+    MultiBoggler33,
+    MultiBoggler34,
+    MultiBoggler44,
+    MultiBoggler45,
+    MultiBoggler55,
+    ParallelBoggler22,
+    ParallelBoggler23,
+    ParallelBoggler33,
+    ParallelBoggler34,
+    ParallelBoggler44,
+    ParallelBoggler45,
+    ParallelBoggler55,
+    ScoreSampler22,
+    ScoreSampler23,
+    ScoreSampler33,
+    ScoreSampler34,
+    ScoreSampler44,
+    ScoreSampler45,
+    ScoreSampler55,
+    WordEnumerator22,
+    WordEnumerator23,
+    WordEnumerator33,
+    WordEnumerator34,
+    WordEnumerator44,
+    WordEnumerator45,
+    WordEnumerator55,
 )
 
 Bogglers = {
@@ -18,6 +74,89 @@ Bogglers = {
     (5, 5): Boggler55,
 }
 
+MultiBogglers = {
+    (2, 2): MultiBoggler22,
+    (2, 3): MultiBoggler23,
+    (3, 3): MultiBoggler33,
+    (3, 4): MultiBoggler34,
+    (4, 4): MultiBoggler44,
+    (4, 5): MultiBoggler45,
+    (5, 5): MultiBoggler55,
+}
+
+IterativeBogglers = {
+    (2, 2): IterativeBoggler22,
+    (2, 3): IterativeBoggler23,
+    (3, 3): IterativeBoggler33,
+    (3, 4): IterativeBoggler34,
+    (4, 4): IterativeBoggler44,
+    (4, 5): IterativeBoggler45,
+    (5, 5): IterativeBoggler55,
+}
+
+# For finding the words on one large board with several threads
+ParallelBogglers = {
+    (2, 2): ParallelBoggler22,
+    (2, 3): ParallelBoggler23,
+    (3, 3): ParallelBoggler33,
+    (3, 4): ParallelBoggler34,
+    (4, 4): ParallelBoggler44,
+    (4, 5): ParallelBoggler45,
+    (5, 5): ParallelBoggler55,
+}
+
+# For use with VersionedTrie
+LiveBogglers = {
+    (2, 2): LiveBoggler22,
+    (2, 3): LiveBoggler23,
+    (3, 3): LiveBoggler33,
+    (3, 4): LiveBoggler34,
+    (4, 4): LiveBoggler44,
+    (4, 5): LiveBoggler45,
+    (5, 5): LiveBoggler55,
+}
+
+CorpusAnalyzers = {
+    (2, 2): CorpusAnalyzer22,
+    (2, 3): CorpusAnalyzer23,
+    (3, 3): CorpusAnalyzer33,
+    (3, 4): CorpusAnalyzer34,
+    (4, 4): CorpusAnalyzer44,
+    (4, 5): CorpusAnalyzer45,
+    (5, 5): CorpusAnalyzer55,
+}
+
+ScoreSamplers = {
+    (2, 2): ScoreSampler22,
+    (2, 3): ScoreSampler23,
+    (3, 3): ScoreSampler33,
+    (3, 4): ScoreSampler34,
+    (4, 4): ScoreSampler44,
+    (4, 5): ScoreSampler45,
+    (5, 5): ScoreSampler55,
+}
+
+WordEnumerators = {
+    (2, 2): WordEnumerator22,
+    (2, 3): WordEnumerator23,
+    (3, 3): WordEnumerator33,
+    (3, 4): WordEnumerator34,
+    (4, 4): WordEnumerator44,
+    (4, 5): WordEnumerator45,
+    (5, 5): WordEnumerator55,
+}
+
+# For use with AlphabetTrie14
+AlphabetBogglers14 = {
+    (2, 2): AlphabetBoggler22_14,
+    (2, 3): AlphabetBoggler23_14,
+    (3, 3): AlphabetBoggler33_14,
+    (3, 4): AlphabetBoggler34_14,
+    (4, 4): AlphabetBoggler44_14,
+    (4, 5): AlphabetBoggler45_14,
+    (5, 5): AlphabetBoggler55_14,
+}
+
 
 # Matches PyBoggler constructor
 def cpp_boggler(t, dims):
@@ -0,0 +1,44 @@
+import functools
+
+from cpp_boggle import Trie
+
+from boggle.dimensional_bogglers import Bogglers, IterativeBogglers
+
+
+@functools.cache
+def get_trie():
+    return Trie.create_from_file("wordlists/enable2k.txt")
+
+
+def test_matches_boggler():
+    t = get_trie()
+    b = Bogglers[(4, 4)](t)
+    ib = IterativeBogglers[(4, 4)](t)
+    for bd in ("abcdefghijklmnop", "perslatgsineters", "besbrrneeeehbteq"):
+        assert ib.score_with_budget(bd) == (b.score(bd), True)
+
+    ib = IterativeBogglers[(3, 3)](t)
+    assert ib.score_with_budget("streaedlp") == (545, True)
+    # '.' cells are skipped.
+    assert ib.score_with_budget("str.aedlp")[1]
+    assert ib.score_with_budget("abc") == (-1, True)
+
+
+def test_budget_and_resume():
+    t = get_trie()
+    ib = IterativeBogglers[(4, 4)](t)
+    bd = "perslatgsineters"
+    score, finished = ib.score_with_budget(bd, max_visits=500)
+    assert not finished
+    assert 0 < score < 3625
+    assert ib.visits() == 500
+
+    # Another Boggler can use the Trie while the search is paused.
+    assert Bogglers[(4, 4)](t).score(bd) == 3625
+
+    calls = 1
+    while not ib.run(max_visits=500):
+        calls += 1
+    assert calls > 1
+    assert ib.done()
+    assert ib.score() == 3625
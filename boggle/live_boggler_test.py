@@ -0,0 +1,64 @@
+import random
+import string
+from concurrent.futures import ThreadPoolExecutor
+
+from cpp_boggle import Trie, VersionedTrie
+
+from boggle.dimensional_bogglers import Bogglers, LiveBogglers
+
+
+def test_versioned_trie():
+    t = VersionedTrie.create_from_wordlist(["tea", "sea", "queen", "qi"])
+    # "qi" can't be spelled on a Boggle board.
+    assert t.size() == 3
+    assert t.version() == 1
+
+    assert t.update(["teas", "eat"], ["sea", "nope"]) == 2
+    assert t.size() == 4
+
+
+def test_live_boggler():
+    t = VersionedTrie.create_from_wordlist(["tea", "sea"])
+    b = LiveBogglers[(2, 2)](t)
+    assert b.score("teas") == 2
+    assert b.version() == 1
+
+    # The next board sees the update.
+    t.update(["teas", "eat"], ["sea"])
+    assert b.score("teas") == 3
+    assert b.version() == 2
+
+    # Removed words can be added back.
+    t.update(["sea"], [])
+    assert b.score("teas") == 4
+    assert len(b.find_words("teas", False)) == 4
+
+
+def test_live_scores():
+    t = VersionedTrie.create_from_file("wordlists/enable2k.txt")
+    b = LiveBogglers[(3, 3)](t)
+    assert b.score("streaedlp") == 545
+    t.update([], ["streaedlp"])
+    assert b.score("streaedlp") == 545
+    t.update([], ["star", "step"])
+    assert b.score("streaedlp") == 543
+
+
+def test_shared_snapshots():
+    # LiveBogglers on different threads can share a VersionedTrie.
+    t = VersionedTrie.create_from_file("wordlists/enable2k.txt")
+    ref = Bogglers[(4, 4)](Trie.create_from_file("wordlists/enable2k.txt"))
+    rng = random.Random(808813)
+    boards = [
+        "".join(rng.choice(string.ascii_lowercase) for _ in range(16))
+        for _ in range(1000)
+    ]
+    expected = [ref.score(bd) for bd in boards]
+
+    def score_all(b):
+        return [b.score(bd) for bd in boards]
+
+    bogglers = [LiveBogglers[(4, 4)](t) for _ in range(2)]
+    with ThreadPoolExecutor(len(bogglers)) as pool:
+        for scores in pool.map(score_all, bogglers):
+            assert scores == expected
@@ -0,0 +1,52 @@
+import functools
+
+from cpp_boggle import MultiTrie
+
+from boggle.dimensional_bogglers import MultiBogglers
+
+
+@functools.cache
+def get_multi_trie():
+    return MultiTrie.create_from_files(
+        ["wordlists/twl06.txt", "wordlists/enable2k.txt"]
+    )
+
+
+def test_multi_trie():
+    t = MultiTrie.create_from_wordlists([["tea", "sea"], ["tea", "teapot"]])
+    assert t.size() == 3
+    assert t.find_word("sea").dictionaries() == 0b01
+    assert t.find_word("tea").dictionaries() == 0b11
+    assert t.find_word("teapot").dictionaries() == 0b10
+    assert t.find_word("teap") is None
+
+
+def test_multi_score():
+    # These match Boggler scores for each dictionary on its own.
+    t = get_multi_trie()
+    b = MultiBogglers[(3, 3)](t)
+    assert b.num_dictionaries() == 2
+    assert b.score("streaedlp") == [546, 545]
+    assert b.score("abcdefghi") == [21, 20]
+
+    b = MultiBogglers[(4, 4)](t)
+    assert b.score("abcdefghijklmnop") == [20, 18]
+    assert b.score("perslatgsineters") == [3663, 3625]
+
+    b = MultiBogglers[(5, 5)](t)
+    assert b.score("sepesdsracietilmanesligdr") == [10759, 10406]
+
+
+def test_empty_dictionaries():
+    # Dictionaries with no words still get a score.
+    t = MultiTrie.create_from_wordlists([["tea"], [], ["eat"], []])
+    assert t.num_dictionaries() == 4
+    b = MultiBogglers[(2, 2)](t)
+    assert b.num_dictionaries() == 4
+    assert b.score("teaq") == [1, 0, 1, 0]
+    assert b.score("abc") == [-1, -1, -1, -1]
+
+    t = MultiTrie()
+    assert MultiBogglers[(2, 2)](t).score("teaq") == []
+    t.add_word("tea", 2)
+    assert MultiBogglers[(2, 2)](t).score("teaq") == [0, 0, 1]
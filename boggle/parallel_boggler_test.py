@@ -0,0 +1,46 @@
+import random
+import string
+from concurrent.futures import ThreadPoolExecutor
+
+from cpp_boggle import Trie
+
+from boggle.dimensional_bogglers import Bogglers, ParallelBogglers
+
+
+def test_matches_boggler():
+    t = Trie.create_from_file("wordlists/enable2k.txt")
+    boards = {
+        (3, 3): ["streaedlp", "abcdefghi", "str.aedlp"],
+        (4, 4): ["perslatgsineters", "eeesrvrreeesrsrs", "abcdefghijklmnop"],
+        (5, 5): ["sepesdsracietilmanesligdr", "qsepesdsracietilmanesligd"],
+    }
+    for dims, bds in boards.items():
+        b = Bogglers[dims](t)
+        for num_threads in (1, 4):
+            pb = ParallelBogglers[dims](t, num_threads=num_threads)
+            assert pb.num_threads() == num_threads
+            for bd in bds:
+                for multiboggle in (False, True):
+                    # Same paths, in the same order.
+                    assert pb.find_words(bd, multiboggle) == b.find_words(
+                        bd, multiboggle
+                    )
+
+    pb = ParallelBogglers[(3, 3)](t)
+    assert pb.find_words("abc", False) == [[-1]]
+
+
+def test_overlapping_calls():
+    # find_words releases the GIL, so calls from different threads can overlap.
+    t = Trie.create_from_file("wordlists/enable2k.txt")
+    b = Bogglers[(4, 4)](t)
+    pb = ParallelBogglers[(4, 4)](t, num_threads=2)
+    rng = random.Random(2718)
+    boards = [
+        "".join(rng.choice(string.ascii_lowercase) for _ in range(16))
+        for _ in range(200)
+    ]
+    expected = [b.find_words(bd, False) for bd in boards]
+    with ThreadPoolExecutor(4) as pool:
+        results = list(pool.map(lambda bd: pb.find_words(bd, False), boards))
+    assert results == expected
@@ -13,8 +13,11 @@ import random
 import time
 from typing import Sequence
 
+from cpp_boggle import Alphabet, AlphabetTrie14, PerfCounter
+
 from boggle.args import add_standard_args, get_trie_and_boggler_from_args
 from boggle.constants import A_TO_Z, neighbors
+from boggle.dimensional_bogglers import AlphabetBogglers14
 
 
 def random_board(n: int, letters: Sequence[str]) -> str:
@@ -26,7 +29,7 @@ def main():
         prog="Boggler perf test",
         description="Measure the speed of board evaluation, free from I/O.",
     )
-    add_standard_args(parser, random_seed=True, python=True)
+    add_standard_args(parser, random_seed=True, python=True, huge_pages=True)
     parser.add_argument(
         "--input_file",
         type=str,
@@ -50,15 +53,37 @@ def main():
         action="store_true",
         help="Generate random boards using a 14-letter alphabet instead of 26.",
     )
+    parser.add_argument(
+        "--alphabet_trie",
+        action="store_true",
+        help="With --jpa14, load the dictionary into a 14-letter AlphabetTrie.",
+    )
+    parser.add_argument(
+        "--prune_by_length",
+        action="store_true",
+        help="Skip parts of the dictionary whose words are too long to fit in "
+        "the free cells, and report how many node visits this saves.",
+    )
     args = parser.parse_args()
     if args.random_seed >= 0:
         random.seed(args.random_seed)
 
     n = args.num_boards
-    t, boggler = get_trie_and_boggler_from_args(args)
-
     w, h = args.size // 10, args.size % 10
     letters = "acdegilmnoprst" if args.jpa14 else "abcdefghijklmnopqrstuvwxyz"
+    if args.alphabet_trie:
+        assert args.jpa14, "--alphabet_trie requires --jpa14"
+        assert not args.python, "--alphabet_trie is not supported with --python"
+        t = AlphabetTrie14.create_from_file(args.dictionary, Alphabet(letters))
+        assert t
+        boggler = AlphabetBogglers14[(w, h)](t)
+    else:
+        t, boggler = get_trie_and_boggler_from_args(args)
+    if args.prune_by_length:
+        assert not args.python and not args.alphabet_trie, (
+            "--prune_by_length is only supported with the C++ Trie"
+        )
+
     if args.variations_on:
         board = args.variations_on
         assert len(board) == w * h
@@ -78,18 +103,42 @@ def main():
         print(f"Generating {n} {w}x{h} boards...")
         boards = [random_board(w * h, letters) for _ in range(n)]
 
+    # None if the host doesn't expose the counter.
+    dtlb = PerfCounter.dtlb_load_misses()
+
     total_score = 0
     print("Scoring boards...")
+    if dtlb:
+        dtlb.start()
     start_s = time.time()
-    for board in boards:
-        total_score += boggler.score(board)
+    if args.prune_by_length:
+        for board in boards:
+            total_score += boggler.score_pruned(board)
+    else:
+        for board in boards:
+            total_score += boggler.score(board)
     end_s = time.time()
+    dtlb_misses = dtlb.stop() if dtlb else None
 
     elapsed_s = end_s - start_s
     pace = len(boards) / elapsed_s
 
     print(f"{total_score=}")
     print(f"{elapsed_s:.02f}s, {pace:.02f} bds/sec")
+    if not args.python and not args.alphabet_trie:
+        print(f"nodes on: {t.node_placement()}")
+    if dtlb_misses is not None:
+        per_board = dtlb_misses / len(boards)
+        print(f"dTLB load misses: {dtlb_misses} ({per_board:.1f} per board)")
+    if args.prune_by_length:
+        # Counting visits slows the search down, so do it after timing.
+        unpruned = sum(boggler.score_counting_visits(bd, False)[1] for bd in boards)
+        pruned = sum(boggler.score_counting_visits(bd, True)[1] for bd in boards)
+        saved = 100 * (unpruned - pruned) / max(1, unpruned)
+        print(
+            f"Trie node visits: {unpruned} unpruned, {pruned} pruned "
+            f"({saved:.2f}% saved on {w}x{h})"
+        )
 
 
 if __name__ == "__main__":
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+"""Estimate the distribution of scores for random boards.
+
+$ uv run python -m boggle.sample --size 44 10000000 --random_seed 808813
+"""
+
+import argparse
+import time
+
+from cpp_boggle import BoardModel, Trie
+
+from boggle.args import add_standard_args
+from boggle.dimensional_bogglers import ScoreSamplers
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog="Boggle score sampler",
+        description="Score many random boards on all cores and summarize the scores.",
+    )
+    add_standard_args(parser, random_seed=True)
+    parser.add_argument(
+        "num_boards",
+        type=int,
+        help="Number of boards to sample",
+        default=1_000_000,
+        nargs="?",
+    )
+    parser.add_argument(
+        "--letters",
+        type=str,
+        default="abcdefghijklmnopqrstuvwxyz",
+        help="Draw each cell uniformly from these letters. Repeat a letter to "
+        "make it more likely.",
+    )
+    parser.add_argument(
+        "--dice",
+        type=str,
+        help="File with one die per line (e.g. 'aaeegn'), one per cell. "
+        "Overrides --letters.",
+    )
+    parser.add_argument(
+        "--num_threads",
+        type=int,
+        default=0,
+        help="Number of threads (0 = one per core). Results depend on this.",
+    )
+    parser.add_argument(
+        "--top_k", type=int, default=10, help="Number of top boards to report."
+    )
+    parser.add_argument(
+        "--threshold",
+        type=int,
+        action="append",
+        default=[],
+        help="Report how many boards scored at least this much. May be repeated.",
+    )
+    args = parser.parse_args()
+    seed = args.random_seed if args.random_seed >= 0 else time.time_ns()
+    w, h = args.size // 10, args.size % 10
+
+    if args.dice:
+        dice = [line.strip() for line in open(args.dice) if line.strip()]
+        model = BoardModel.from_dice(dice)
+    else:
+        model = BoardModel.from_letters(args.letters)
+    assert model
+
+    t = Trie.create_from_file(args.dictionary)
+    assert t
+    sampler = ScoreSamplers[(w, h)](t)
+
+    start_s = time.time()
+    summary = sampler.sample(
+        model, args.num_boards, seed, num_threads=args.num_threads, top_k=args.top_k
+    )
+    elapsed_s = time.time() - start_s
+    assert summary
+
+    n = summary.num_boards()
+    print(f"{seed=}")
+    print(f"{n} boards in {elapsed_s:.02f}s, {n / elapsed_s:.02f} bds/sec")
+    print(f"mean={summary.mean():.2f} std_dev={summary.std_dev():.2f}")
+    print(f"min={summary.min_score()} max={summary.max_score()}")
+    for p in (0.5, 0.9, 0.99, 0.999):
+        print(f"p{p * 100:g}={summary.percentile(p)}")
+    for threshold in args.threshold:
+        print(f">= {threshold}: {summary.count_at_least(threshold)}")
+    print("Top boards:")
+    for score, board in summary.top_boards():
+        print(f"  {board}: {score}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,63 @@
+import functools
+
+from cpp_boggle import BoardModel, Trie
+
+from boggle.dimensional_bogglers import Bogglers, ScoreSamplers
+
+
+@functools.cache
+def get_trie():
+    return Trie.create_from_file("wordlists/enable2k.txt")
+
+
+def test_sample_letters():
+    t = get_trie()
+    sampler = ScoreSamplers[(3, 3)](t)
+    model = BoardModel.from_letters("abcdefghijklmnopqrstuvwxyz")
+    s = sampler.sample(model, 1000, 42, num_threads=3, top_k=5)
+    assert s.num_boards() == 1000
+    assert sum(s.histogram()) == 1000
+    assert s.min_score() <= s.percentile(0.5) <= s.max_score()
+    assert s.count_at_least(0) == 1000
+
+    top = s.top_boards()
+    assert len(top) == 5
+    assert top[0][0] == s.max_score()
+    assert [score for score, _ in top] == sorted(
+        [score for score, _ in top], reverse=True
+    )
+    # The sampler's scores match Boggler's.
+    b = Bogglers[(3, 3)](t)
+    for score, board in top:
+        assert b.score(board) == score
+
+    # Same seed and thread count, same results.
+    s2 = sampler.sample(model, 1000, 42, num_threads=3, top_k=5)
+    assert s2.histogram() == s.histogram()
+    assert s2.top_boards() == top
+
+
+def test_sample_dice():
+    t = get_trie()
+    sampler = ScoreSamplers[(2, 2)](t)
+    model = BoardModel.from_dice(["t", "e", "a", "s"])
+    s = sampler.sample(model, 100, 1, num_threads=2, top_k=1)
+    # Every board is a permutation of "teas".
+    assert s.min_score() == s.max_score()
+    assert s.top_boards()[0][1] == "aest"
+
+    # There must be one die per cell.
+    assert ScoreSamplers[(3, 3)](t).sample(model, 100, 1) is None
+    assert BoardModel.from_letters("ABC") is None
+
+
+def test_trie_built_by_hand():
+    # This relies on add_word giving each word its own id.
+    t = Trie()
+    for word in ("tea", "eat", "ate", "sea", "seat", "teas"):
+        t.add_word(word)
+    model = BoardModel.from_dice(["t", "e", "a", "s"])
+    s = ScoreSamplers[(2, 2)](t).sample(model, 100, 1, num_threads=2, top_k=1)
+    # Every cell is next to every other one on a 2x2 board.
+    assert s.min_score() == s.max_score() == 6
+    assert Bogglers[(2, 2)](t).score(s.top_boards()[0][1]) == 6
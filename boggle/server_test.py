@@ -0,0 +1,166 @@
+import os
+import select
+import socket
+import struct
+import subprocess
+import tempfile
+import time
+
+import pytest
+
+SERVER = "./boggle_server"
+
+# See cpp/server_protocol.h
+SCORE, FIND_WORDS, STATS = 1, 2, 3
+MULTIBOGGLE = 1
+OK, BAD_REQUEST = 0, 1
+
+
+def start_server(dictionary, **kwargs):
+    if not os.path.exists(SERVER):
+        pytest.skip("run `make server` first")
+    path = os.path.join(tempfile.mkdtemp(), "boggle.sock")
+    proc = subprocess.Popen(
+        [SERVER, "--dictionary", dictionary, "--socket", path], **kwargs
+    )
+    # Wait for the dictionary to load.
+    for _ in range(100):
+        try:
+            socket.socket(socket.AF_UNIX).connect(path)
+            break
+        except OSError:
+            time.sleep(0.1)
+    return proc, path
+
+
+@pytest.fixture(scope="module")
+def server_socket():
+    proc, path = start_server("wordlists/enable2k.txt")
+    yield path
+    proc.terminate()
+    proc.wait()
+    assert not os.path.exists(path)
+
+
+def encode(request_id, op, w, h, board, flags=0):
+    body = struct.pack("<IBBBB", request_id, op, w, h, flags) + board.encode()
+    return struct.pack("<I", len(body)) + body
+
+
+def read_responses(sock, n):
+    buf = b""
+    out = {}
+    while len(out) < n:
+        chunk = sock.recv(65536)
+        assert chunk
+        buf += chunk
+        while len(buf) >= 4:
+            (length,) = struct.unpack_from("<I", buf)
+            if len(buf) < 4 + length:
+                break
+            request_id, op, status = struct.unpack_from("<IBB", buf, 4)
+            out[request_id] = (op, status, buf[12 : 4 + length])
+            buf = buf[4 + length :]
+    return out
+
+
+def decode_paths(payload):
+    (n,) = struct.unpack_from("<I", payload)
+    pos = 4
+    paths = []
+    for _ in range(n):
+        length = payload[pos]
+        paths.append(list(payload[pos + 1 : pos + 1 + length]))
+        pos += 1 + length
+    return paths
+
+
+def test_pipelined_requests(server_socket):
+    sock = socket.socket(socket.AF_UNIX)
+    sock.connect(server_socket)
+    sock.sendall(
+        encode(1, SCORE, 3, 3, "streaedlp")
+        + encode(2, SCORE, 4, 4, "perslatgsineters")
+        + encode(3, SCORE, 5, 5, "sepesdsracietilmanesligdr")
+        + encode(4, SCORE, 4, 4, "abc")
+        + encode(5, FIND_WORDS, 2, 2, "abcd")
+        + encode(6, FIND_WORDS, 2, 2, "abcd", MULTIBOGGLE)
+        + encode(7, 99, 0, 0, "")
+    )
+    r = read_responses(sock, 7)
+    assert r[1] == (SCORE, OK, struct.pack("<i", 545))
+    assert r[2] == (SCORE, OK, struct.pack("<i", 3625))
+    assert r[3] == (SCORE, OK, struct.pack("<i", 10406))
+    assert r[4][:2] == (SCORE, BAD_REQUEST)
+    assert r[5][:2] == (FIND_WORDS, OK)
+    # bad, cab, cad, dab
+    assert sorted(decode_paths(r[5][2])) == [[1, 0, 3], [2, 0, 1], [2, 0, 3], [3, 0, 1]]
+    assert r[6][:2] == (FIND_WORDS, OK)
+    assert r[7][:2] == (99, BAD_REQUEST)
+
+    sock.sendall(encode(8, STATS, 0, 0, ""))
+    op, status, payload = read_responses(sock, 1)[8]
+    assert (op, status) == (STATS, OK)
+    requests, batches, queue_depth = struct.unpack_from("<QQQ", payload)
+    assert requests >= 6
+    assert 1 <= batches <= requests
+    assert queue_depth == 0
+
+
+def test_board_sizes(server_socket):
+    sock = socket.socket(socket.AF_UNIX)
+    sock.connect(server_socket)
+    # Each dimension must be 2-5 on its own, even if the pair looks like 3x3.
+    sock.sendall(
+        encode(1, SCORE, 3, 3, "streaedlp")
+        + encode(2, SCORE, 0, 33, "streaedlp")
+        + encode(3, SCORE, 1, 23, "streaedlp")
+        + encode(4, SCORE, 6, 6, "a" * 36)
+    )
+    r = read_responses(sock, 4)
+    assert r[1] == (SCORE, OK, struct.pack("<i", 545))
+    for request_id in (2, 3, 4):
+        assert r[request_id][:2] == (SCORE, BAD_REQUEST)
+
+
+def test_bad_boards_are_not_logged():
+    proc, path = start_server("testdata/boggle-words-4.txt", stderr=subprocess.PIPE)
+    sock = socket.socket(socket.AF_UNIX)
+    sock.connect(path)
+    sock.sendall(
+        encode(1, SCORE, 2, 2, "ABCD")
+        + encode(2, SCORE, 2, 2, "abc")
+        + encode(3, FIND_WORDS, 2, 2, "ab\0d")
+    )
+    r = read_responses(sock, 3)
+    assert all(status == BAD_REQUEST for _, status, _ in r.values())
+    proc.terminate()
+    _, stderr = proc.communicate()
+    assert b"letter" not in stderr
+    assert b"Board strings" not in stderr
+
+
+def test_client_that_does_not_read(server_socket):
+    # Once a client has enough unread responses, the server stops reading its
+    # requests rather than buffering them without limit.
+    sock = socket.socket(socket.AF_UNIX)
+    sock.connect(server_socket)
+    request = encode(1, FIND_WORDS, 4, 4, "perslatgsineters", MULTIBOGGLE)
+    data = request * 100_000
+    sock.setblocking(False)
+    sent = 0
+    while sent < len(data):
+        try:
+            sent += sock.send(data[sent:])
+        except BlockingIOError:
+            _, writable, _ = select.select([], [sock], [], 1.0)
+            if not writable:
+                break
+    assert sent < len(data) // 2
+    sock.close()
+
+    # Other clients are still served.
+    sock = socket.socket(socket.AF_UNIX)
+    sock.connect(server_socket)
+    sock.sendall(encode(1, SCORE, 3, 3, "streaedlp"))
+    assert read_responses(sock, 1)[1] == (SCORE, OK, struct.pack("<i", 545))
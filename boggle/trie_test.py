@@ -62,3 +62,151 @@ def test_load_file():
 
     assert t.find_word("wood") is not None
     assert t.find_word("woxd") is None
+
+
+def test_load_file_bulk(tmp_path):
+    t = Trie.create_from_file("testdata/boggle-words-4.txt")
+    for num_threads in (1, 4):
+        bt = Trie.create_from_file_bulk("testdata/boggle-words-4.txt", num_threads)
+        assert bt.size() == t.size()
+        assert bt.num_nodes() == t.num_nodes()
+        assert bt.find_word("wood") is not None
+        assert bt.find_word("woxd") is None
+
+    # Words can still be added after a bulk load.
+    assert bt.find_word("woxd") is None
+    bt.add_word("woxd")
+    assert bt.find_word("woxd") is not None
+
+    # Unsorted word lists fall back to create_from_file
+    unsorted = tmp_path / "unsorted.txt"
+    unsorted.write_text("tea\nsea\nquart\nteapot\n")
+    t = Trie.create_from_file_bulk(str(unsorted))
+    assert t.size() == 4
+    assert t.find_word("qart") is not None
+
+
+def test_stats():
+    t = Trie.create_from_wordlist(["tea", "teapot", "sea"])
+    s = t.stats()
+    assert s.num_words == 3
+    assert s.num_nodes == t.num_nodes() == 10
+    assert s.nodes_at_depth == [1, 2, 2, 2, 1, 1, 1]
+    assert s.words_at_depth == [0, 0, 0, 2, 0, 0, 1]
+    # The root has two children ("s", "t"), "tea" has one ("p").
+    assert s.child_counts_at_depth[0][2] == 1
+    assert s.child_counts_at_depth[3][1] == 1
+    assert s.average_children() == 9 / 8
+    node_bytes = s.bytes // s.num_nodes
+
+    # Stats are kept up to date as words are added.
+    t.add_word("sew")
+    s = t.stats()
+    assert s.num_words == 4
+    assert s.num_nodes == 11
+    assert s.child_counts_at_depth[2][2] == 1
+    assert s.bytes == 11 * node_bytes
+
+    # A subtree's stats come from a walk.
+    sub = t.descend(asc("t")).stats()
+    assert sub.num_words == 2
+    assert sub.num_nodes == 6
+
+
+def test_bulk_stats():
+    t = Trie.create_from_file("testdata/boggle-words-4.txt")
+    s = t.stats()
+    assert s.num_words == t.size()
+    assert s.num_nodes == t.num_nodes()
+    for num_threads in (1, 4):
+        bs = Trie.create_from_file_bulk(
+            "testdata/boggle-words-4.txt", num_threads
+        ).stats()
+        assert bs.bytes == s.bytes
+        assert bs.num_nodes == s.num_nodes
+        assert bs.num_words == s.num_words
+        assert bs.nodes_at_depth == s.nodes_at_depth
+        assert bs.words_at_depth == s.words_at_depth
+        assert bs.child_counts_at_depth == s.child_counts_at_depth
+
+
+def test_word_ids(tmp_path):
+    # Words added to a plain Trie get distinct ids, in order.
+    t = Trie()
+    for word in ("tea", "sea", "teapot"):
+        t.add_word(word)
+    assert [t.find_word(w).word_id() for w in ("tea", "sea", "teapot")] == [0, 1, 2]
+    assert t.stats().num_words == 3
+
+    # Every loader numbers words by their position in the list, so a duplicate
+    # gets the id of its last occurrence.
+    words = ["abc", "abc", "bcd", "cde"]
+    path = tmp_path / "dupes.txt"
+    path.write_text("\n".join(words) + "\n")
+    for t in (
+        Trie.create_from_file(str(path)),
+        Trie.create_from_file_bulk(str(path)),
+        Trie.create_from_wordlist(words),
+    ):
+        assert [t.find_word(w).word_id() for w in ("abc", "bcd", "cde")] == [1, 2, 3]
+
+    # Words added after a bulk load don't reuse an id.
+    bt = Trie.create_from_file_bulk("testdata/boggle-words-4.txt")
+    assert bt.add_word("woxd").word_id() == bt.size() - 1
+
+
+def test_huge_pages():
+    path = "testdata/boggle-words-4.txt"
+    t = Trie.create_from_file(path)
+    assert t.node_placement() == "heap"
+    node_bytes = t.stats().bytes // t.num_nodes()
+    for ht in (
+        Trie.create_from_file(path, huge_pages=True),
+        Trie.create_from_file_bulk(path, huge_pages=True),
+    ):
+        # Huge pages may not be available, but the Trie should be the same.
+        kinds = set(ht.node_placement().split("+"))
+        assert kinds <= {"hugetlb", "thp", "regular", "heap"}
+        assert ht.size() == t.size()
+        assert ht.num_nodes() == t.num_nodes()
+        assert ht.find_word("aahs").word_id() == t.find_word("aahs").word_id()
+        # Memory is counted in whole 2 MB regions, plus the root.
+        assert ht.stats().bytes > t.stats().bytes
+        assert (ht.stats().bytes - node_bytes) % (2 << 20) == 0
+
+    t = Trie.create_from_wordlist(["tea", "teas", "eat"], huge_pages=True)
+    t.add_word("tee")
+    assert t.size() == 4
+    assert t.stats().num_nodes == 9
+
+
+def test_remaining_lengths():
+    t = Trie.create_from_wordlist(["tea", "teas", "eat"])
+    assert (t.min_remaining(), t.max_remaining()) == (3, 4)
+    te = t.descend(asc("t")).descend(asc("e"))
+    assert (te.min_remaining(), te.max_remaining()) == (1, 2)
+    tea = te.descend(asc("a"))
+    assert (tea.min_remaining(), tea.max_remaining()) == (0, 1)
+    teas = tea.descend(asc("s"))
+    assert (teas.min_remaining(), teas.max_remaining()) == (0, 0)
+
+    # These are in Trie edges, so "qui" (stored as "qi") counts as two.
+    t.add_word("qi")
+    q = t.descend(asc("q"))
+    assert (q.min_remaining(), q.max_remaining()) == (1, 1)
+    assert (t.min_remaining(), t.max_remaining()) == (2, 4)
+
+    path = "testdata/boggle-words-4.txt"
+    t = Trie.create_from_file(path)
+    for bt in (
+        Trie.create_from_file_bulk(path, 1),
+        Trie.create_from_file_bulk(path, 4),
+    ):
+        assert bt.min_remaining() == t.min_remaining()
+        assert bt.max_remaining() == t.max_remaining()
+        for word in ("wood", "aahs"):
+            node, bnode = t, bt
+            for c in word:
+                node, bnode = node.descend(asc(c)), bnode.descend(asc(c))
+                assert bnode.min_remaining() == node.min_remaining()
+                assert bnode.max_remaining() == node.max_remaining()
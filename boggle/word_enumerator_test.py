@@ -0,0 +1,49 @@
+import itertools
+
+from cpp_boggle import Trie
+
+from boggle.dimensional_bogglers import Bogglers, WordEnumerators
+
+
+def word_length(bd, path):
+    # "Qu" counts as two letters.
+    return sum(2 if bd[i] == "q" else 1 for i in path)
+
+
+def test_matches_find_words():
+    t = Trie.create_from_file("wordlists/enable2k.txt")
+    for dims, bd in (
+        ((3, 3), "streaedlp"),
+        ((4, 4), "perslatgsineters"),
+        ((4, 4), "qaplatgsinetersq"),
+        ((5, 5), "sepesdsracietilmanesligdr"),
+    ):
+        paths = Bogglers[dims](t).find_words(bd, False)
+        e = WordEnumerators[dims](t)
+        words = list(e.words(bd))
+        assert [path for _, path in words] == paths
+        assert len({word_id for word_id, _ in words}) == len(words)
+
+        long_words = list(e.words(bd, min_length=6))
+        assert long_words == [(w, p) for w, p in words if word_length(bd, p) >= 6]
+
+        wanted = [words[-1][0], words[0][0]]
+        assert list(e.words(bd, word_ids=wanted)) == [words[0], words[-1]]
+
+    assert list(WordEnumerators[(3, 3)](t).words("abc")) == []
+
+
+def test_early_exit():
+    t = Trie.create_from_file("wordlists/enable2k.txt")
+    e = WordEnumerators[(4, 4)](t)
+    bd = "perslatgsineters"
+    first = list(itertools.islice(e.words(bd), 3))
+    assert first == list(e.words(bd))[:3]
+
+    tea = t.find_word("tea").word_id()
+    for word_id, path in e.words("streaedlpabcdefg"):
+        if word_id == tea:
+            break
+    else:
+        assert False, "tea not found"
+    assert "".join("streaedlpabcdefg"[i] for i in path) == "tea"
@@ -0,0 +1,90 @@
+// Solver for MxN Boggle using an AlphabetTrie.
+#ifndef ALPHABET_BOGGLER_H
+#define ALPHABET_BOGGLER_H
+
+#include "alphabet_trie.h"
+#include "constants.h"
+#include "neighbors.h"
+
+template <int M, int N, int K>
+class AlphabetBoggler {
+ public:
+  using Node = typename AlphabetTrie<K>::Node;
+
+  AlphabetBoggler(AlphabetTrie<K>* t)
+      : dict_(t), q_(t->GetAlphabet().QCode()), runs_(0) {}
+
+  // Letters outside the trie's alphabet can't be part of any word, so they're
+  // treated like '.' cells. Returns -1 for an invalid board.
+  int Score(const char* lets);
+
+  unsigned int NumCells() { return M * N; }
+
+ private:
+  void DoDFS(unsigned int i, unsigned int len, Node* t);
+  bool ParseBoard(const char* bd);
+
+  AlphabetTrie<K>* dict_;
+  int q_;
+  unsigned int used_;
+  unsigned int blocked_;  // cells with no letter in the alphabet
+  int bd_[M * N];
+  unsigned int score_;
+  unsigned int runs_;
+};
+
+template <int M, int N, int K>
+bool AlphabetBoggler<M, N, K>::ParseBoard(const char* bd) {
+  if (!ParseBoardString(bd, bd_, M * N)) {
+    return false;
+  }
+  const Alphabet& alphabet = dict_->GetAlphabet();
+  blocked_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i] == -1 ? -1 : alphabet.Code('a' + bd_[i]);
+    if (c == -1) blocked_ |= (1 << i);
+    bd_[i] = c;
+  }
+  return true;
+}
+
+template <int M, int N, int K>
+int AlphabetBoggler<M, N, K>::Score(const char* lets) {
+  if (!ParseBoard(lets)) {
+    return -1;
+  }
+  Node* root = dict_->Root();
+  runs_ = root->mark + 1;
+  root->mark = runs_;
+  used_ = blocked_;
+  score_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (c != -1 && dict_->StartsWord(root, c)) DoDFS(i, 0, dict_->Descend(root, c));
+  }
+  return score_;
+}
+
+template <int M, int N, int K>
+void AlphabetBoggler<M, N, K>::DoDFS(unsigned int i, unsigned int len, Node* t) {
+  int c = bd_[i];
+  used_ ^= (1 << i);
+  len += (c == q_ ? 2 : 1);
+  if (t->IsWord() && t->mark != runs_) {
+    t->mark = runs_;
+    score_ += kWordScores[len];
+  }
+
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (dict_->StartsWord(t, cc)) {
+        DoDFS(idx, len, dict_->Descend(t, cc));
+      }
+    }
+  });
+
+  used_ ^= (1 << i);
+}
+
+#endif  // ALPHABET_BOGGLER_H
@@ -0,0 +1,215 @@
+// A Trie restricted to a reduced alphabet of at most K letters.
+//
+// Words that use letters outside the alphabet are dropped at build time, and
+// each node only has child slots for the letters in the alphabet. Nodes live in
+// one contiguous array and refer to their children by index, so for K=14 a node
+// fits in a single 64-byte cache line (vs. 232 bytes for a Trie node).
+#ifndef ALPHABET_TRIE_H__
+#define ALPHABET_TRIE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trie.h"
+
+using namespace std;
+
+// Maps between letters and dense codes 0..Size()-1.
+class Alphabet {
+ public:
+  // Characters other than a-z and repeated letters are ignored.
+  Alphabet(const string& letters) {
+    for (int i = 0; i < kNumLetters; i++) codes_[i] = -1;
+    for (char c : letters) {
+      if (c < 'a' || c > 'z' || codes_[c - 'a'] != -1) {
+        fprintf(stderr, "Ignoring '%c' in alphabet '%s'\n", c, letters.c_str());
+        continue;
+      }
+      codes_[c - 'a'] = letters_.size();
+      letters_.push_back(c);
+    }
+  }
+
+  int Size() const { return letters_.size(); }
+  const string& Letters() const { return letters_; }
+
+  // Returns -1 if the letter is not in the alphabet.
+  int Code(char c) const { return (c >= 'a' && c <= 'z') ? codes_[c - 'a'] : -1; }
+  char Letter(int code) const { return letters_[code]; }
+  int QCode() const { return codes_[kQ]; }
+
+  // Does the alphabet contain every letter of this word?
+  bool Covers(const char* word) const {
+    for (const char* p = word; *p; p++) {
+      if (Code(*p) == -1) return false;
+    }
+    return true;
+  }
+
+ private:
+  string letters_;
+  int codes_[kNumLetters];
+};
+
+template <int K>
+class AlphabetTrie {
+ public:
+  static constexpr uint32_t kNotAWord = 0xffffffff;
+
+  struct Node {
+    // Index into nodes_, or 0 for no child (the root is never a child).
+    uint32_t children[K];
+    uint32_t word_id;  // kNotAWord if this is not a word.
+    uint32_t mark;
+
+    bool IsWord() const { return word_id != kNotAWord; }
+  };
+
+  const Alphabet& GetAlphabet() const { return alphabet_; }
+
+  // Fast operations
+  Node* Root() { return &nodes_[0]; }
+  bool StartsWord(const Node* n, int c) const { return n->children[c]; }
+  Node* Descend(const Node* n, int c) { return &nodes_[n->children[c]]; }
+
+  // Trie construction. Returns the index of the node at the end of the word,
+  // or kNotAWord (leaving the Trie unchanged) if the alphabet doesn't cover it.
+  uint32_t AddWord(const char* wd, uint32_t word_id);
+  // These return NULL if the alphabet has more than K letters.
+  static unique_ptr<AlphabetTrie> CreateFromFile(
+      const char* filename, const Alphabet& alphabet
+  );
+  static unique_ptr<AlphabetTrie> CreateFromWordlist(
+      const vector<string>& words, const Alphabet& alphabet
+  );
+
+  size_t Size() const;
+  size_t NumNodes() const { return nodes_.size(); }
+  size_t BytesUsed() const { return nodes_.capacity() * sizeof(Node); }
+  // Returns kNotAWord if the word is not in the Trie.
+  uint32_t FindWordId(const string& word) const;
+
+ private:
+  AlphabetTrie(const Alphabet& alphabet) : alphabet_(alphabet) {
+    nodes_.push_back(EmptyNode());
+  }
+
+  static bool CheckAlphabet(const Alphabet& alphabet) {
+    if (alphabet.Size() <= K) return true;
+    fprintf(
+        stderr,
+        "Alphabet '%s' has more than %d letters\n",
+        alphabet.Letters().c_str(),
+        K
+    );
+    return false;
+  }
+
+  static Node EmptyNode() {
+    Node n;
+    for (int i = 0; i < K; i++) n.children[i] = 0;
+    n.word_id = kNotAWord;
+    n.mark = 0;
+    return n;
+  }
+
+  Alphabet alphabet_;
+  vector<Node> nodes_;
+};
+
+template <int K>
+uint32_t AlphabetTrie<K>::AddWord(const char* wd, uint32_t word_id) {
+  if (!alphabet_.Covers(wd)) return kNotAWord;
+  uint32_t idx = 0;
+  for (; *wd; wd++) {
+    int c = alphabet_.Code(*wd);
+    if (!nodes_[idx].children[c]) {
+      uint32_t child = nodes_.size();
+      nodes_.push_back(EmptyNode());  // may invalidate references into nodes_
+      nodes_[idx].children[c] = child;
+    }
+    idx = nodes_[idx].children[c];
+  }
+  nodes_[idx].word_id = word_id;
+  return idx;
+}
+
+template <int K>
+size_t AlphabetTrie<K>::Size() const {
+  size_t size = 0;
+  for (const auto& n : nodes_) {
+    if (n.IsWord()) size++;
+  }
+  return size;
+}
+
+template <int K>
+uint32_t AlphabetTrie<K>::FindWordId(const string& word) const {
+  uint32_t idx = 0;
+  for (char let : word) {
+    int c = alphabet_.Code(let);
+    if (c == -1 || !nodes_[idx].children[c]) return kNotAWord;
+    idx = nodes_[idx].children[c];
+  }
+  return nodes_[idx].word_id;
+}
+
+template <int K>
+unique_ptr<AlphabetTrie<K>> AlphabetTrie<K>::CreateFromFile(
+    const char* filename, const Alphabet& alphabet
+) {
+  if (!CheckAlphabet(alphabet)) return NULL;
+  char line[80];
+  FILE* f = fopen(filename, "r");
+  if (!f) {
+    fprintf(stderr, "Couldn't open %s\n", filename);
+    return NULL;
+  }
+
+  int count = 0, pruned = 0;
+  unique_ptr<AlphabetTrie<K>> t(new AlphabetTrie<K>(alphabet));
+  while (fscanf(f, "%s", line) == 1) {
+    if (!Trie::BogglifyWord(line)) continue;
+    if (t->AddWord(line, count) == kNotAWord) {
+      pruned++;
+      continue;
+    }
+    count++;
+  }
+  fclose(f);
+  t->nodes_.shrink_to_fit();
+
+  fprintf(
+      stderr,
+      "Loaded %d words (pruned %d outside '%s') into AlphabetTrie<%d> with %zu "
+      "nodes using %zu bytes (%zu bytes per node)\n",
+      count,
+      pruned,
+      alphabet.Letters().c_str(),
+      K,
+      t->NumNodes(),
+      t->BytesUsed(),
+      sizeof(Node)
+  );
+  return t;
+}
+
+template <int K>
+unique_ptr<AlphabetTrie<K>> AlphabetTrie<K>::CreateFromWordlist(
+    const vector<string>& words, const Alphabet& alphabet
+) {
+  if (!CheckAlphabet(alphabet)) return NULL;
+  int count = 0;
+  unique_ptr<AlphabetTrie<K>> t(new AlphabetTrie<K>(alphabet));
+  for (const auto& word : words) {
+    if (t->AddWord(word.c_str(), count) != kNotAWord) count++;
+  }
+  t->nodes_.shrink_to_fit();
+  return t;
+}
+
+#endif  // ALPHABET_TRIE_H__
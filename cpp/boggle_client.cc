@@ -0,0 +1,143 @@
+#include "boggle_client.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace server_protocol;
+
+// Linux has MSG_NOSIGNAL; macOS and the BSDs have SO_NOSIGPIPE (see Connect).
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+unique_ptr<BoggleClient> BoggleClient::Connect(const string& socket_path) {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "Socket path is too long: %s\n", socket_path.c_str());
+    return NULL;
+  }
+  strcpy(addr.sun_path, socket_path.c_str());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+  }
+  if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+    perror(("Couldn't connect to " + socket_path).c_str());
+    if (fd >= 0) close(fd);
+    return NULL;
+  }
+  return unique_ptr<BoggleClient>(new BoggleClient(fd));
+}
+
+BoggleClient::~BoggleClient() { close(fd_); }
+
+uint32_t BoggleClient::Send(
+    uint8_t op, int width, int height, uint8_t flags, const string& board
+) {
+  Request req;
+  req.request_id = next_id_++;
+  req.op = op;
+  req.width = width;
+  req.height = height;
+  req.flags = flags;
+  req.board = board;
+  EncodeRequest(req, &out_);
+  return req.request_id;
+}
+
+uint32_t BoggleClient::SendScore(int width, int height, const string& board) {
+  return Send(kScore, width, height, 0, board);
+}
+
+uint32_t BoggleClient::SendFindWords(
+    int width, int height, const string& board, bool multiboggle
+) {
+  return Send(kFindWords, width, height, multiboggle ? kMultiboggle : 0, board);
+}
+
+uint32_t BoggleClient::SendStats() { return Send(kStats, 0, 0, 0, ""); }
+
+bool BoggleClient::Flush() {
+  size_t pos = 0;
+  while (pos < out_.size()) {
+    ssize_t n = send(fd_, out_.data() + pos, out_.size() - pos, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      perror("send");
+      return false;
+    }
+    pos += n;
+  }
+  out_.clear();
+  return true;
+}
+
+bool BoggleClient::ReadResponse(Response* resp) {
+  if (!out_.empty() && !Flush()) return false;
+  while (true) {
+    const char* body;
+    int64_t size =
+        NextFrame(in_.data() + in_pos_, in_.size() - in_pos_, kResponseHeaderSize, &body);
+    if (size < 0) {
+      fprintf(stderr, "Malformed response from server\n");
+      return false;
+    }
+    if (size > 0) {
+      DecodeResponse(body, size - 4, resp);
+      in_pos_ += size;
+      return true;
+    }
+
+    // Drop the frames that have been read before reading more.
+    in_.erase(0, in_pos_);
+    in_pos_ = 0;
+    char buf[65536];
+    ssize_t n = recv(fd_, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      if (n < 0) perror("recv");
+      return false;
+    }
+    in_.append(buf, n);
+  }
+}
+
+bool BoggleClient::Call(uint32_t id, Response* resp) {
+  if (!ReadResponse(resp)) return false;
+  if (resp->request_id != id) {
+    fprintf(stderr, "Expected response to %u, got %u\n", id, resp->request_id);
+    return false;
+  }
+  return resp->status == kOk;
+}
+
+int BoggleClient::Score(int width, int height, const string& board) {
+  Response resp;
+  if (!Call(SendScore(width, height, board), &resp) || resp.payload.size() != 4) {
+    return -1;
+  }
+  return GetU32(resp.payload.data());
+}
+
+bool BoggleClient::FindWords(
+    int width, int height, const string& board, bool multiboggle, vector<vector<int>>* paths
+) {
+  Response resp;
+  return Call(SendFindWords(width, height, board, multiboggle), &resp) &&
+         DecodePaths(resp.payload, paths);
+}
+
+bool BoggleClient::Stats(ServerStats* stats) {
+  Response resp;
+  return Call(SendStats(), &resp) && DecodeStats(resp.payload, stats);
+}
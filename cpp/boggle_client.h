@@ -0,0 +1,69 @@
+// Client for boggle_server.
+#ifndef BOGGLE_CLIENT_H
+#define BOGGLE_CLIENT_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "server_protocol.h"
+
+using namespace std;
+
+// One connection to a boggle_server. Not thread-safe: use one per thread.
+//
+// Requests can be pipelined: call Send*() any number of times, then read the
+// responses with ReadResponse(), matching them up by request id.
+//
+//   auto c = BoggleClient::Connect("/tmp/boggle.sock");
+//   uint32_t a = c->SendScore(4, 4, "abcdefghijklmnop");
+//   uint32_t b = c->SendScore(4, 4, "perslatgsineters");
+//   server_protocol::Response r;
+//   while (c->ReadResponse(&r)) { ... }
+//
+// The blocking Score(), FindWords() and Stats() calls send one request and wait
+// for its response, so they can't be mixed with unanswered pipelined requests.
+class BoggleClient {
+ public:
+  // Returns NULL (and logs) if the server can't be reached.
+  static unique_ptr<BoggleClient> Connect(const string& socket_path);
+  ~BoggleClient();
+
+  // These queue up a request and return its id. Nothing is sent until Flush()
+  // or ReadResponse() is called.
+  uint32_t SendScore(int width, int height, const string& board);
+  uint32_t SendFindWords(int width, int height, const string& board, bool multiboggle);
+  uint32_t SendStats();
+
+  // Sends all queued requests. Returns false if the connection is broken.
+  bool Flush();
+
+  // Flushes, then blocks until a response arrives. Returns false if the
+  // connection is closed or broken.
+  bool ReadResponse(server_protocol::Response* resp);
+
+  // Returns -1 for an invalid board or a broken connection.
+  int Score(int width, int height, const string& board);
+  // Returns false for an invalid board or a broken connection.
+  bool FindWords(
+      int width, int height, const string& board, bool multiboggle, vector<vector<int>>* paths
+  );
+  bool Stats(server_protocol::ServerStats* stats);
+
+ private:
+  BoggleClient(int fd) : fd_(fd), next_id_(0) {}
+
+  uint32_t Send(uint8_t op, int width, int height, uint8_t flags, const string& board);
+  // Sends one request and waits for its response.
+  bool Call(uint32_t id, server_protocol::Response* resp);
+
+  int fd_;
+  uint32_t next_id_;
+  string out_;
+  string in_;
+  size_t in_pos_ = 0;  // start of the first unread frame in in_
+};
+
+#endif  // BOGGLE_CLIENT_H
@@ -0,0 +1,191 @@
+// Load generator for boggle_server. Each client thread keeps a fixed number of
+// random boards in flight and measures how long each one takes to come back.
+//
+//   ./boggle_loadgen --socket /tmp/boggle.sock --clients 8 --pipeline 32 --size 44
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boggle_client.h"
+#include "sampling.h"
+
+using namespace std;
+using namespace server_protocol;
+
+struct Options {
+  string socket_path = "/tmp/boggle.sock";
+  int num_clients = 4;
+  int requests_per_client = 100000;
+  int pipeline = 32;
+  int size = 44;
+  uint64_t seed = 808813;
+  string op = "score";  // or "find" or "multi"
+  string letters = "abcdefghijklmnopqrstuvwxyz";
+};
+
+struct ClientResult {
+  bool ok = true;
+  uint64_t errors = 0;
+  vector<uint64_t> latencies_us;
+};
+
+static void RunClient(const Options& o, const BoardModel& model, int index, ClientResult* result) {
+  auto client = BoggleClient::Connect(o.socket_path);
+  if (!client) {
+    result->ok = false;
+    return;
+  }
+  int w = o.size / 10, h = o.size % 10;
+  mt19937_64 rng(o.seed + index);
+  vector<char> board(w * h + 1);
+  // Request ids are sequential, so this is indexed by id.
+  vector<chrono::steady_clock::time_point> sent(o.requests_per_client);
+
+  auto send_one = [&]() {
+    model.Generate(rng, w * h, board.data());
+    uint32_t id;
+    if (o.op == "score") {
+      id = client->SendScore(w, h, board.data());
+    } else {
+      id = client->SendFindWords(w, h, board.data(), o.op == "multi");
+    }
+    sent[id] = chrono::steady_clock::now();
+  };
+
+  int num_sent = 0;
+  for (; num_sent < min(o.pipeline, o.requests_per_client); num_sent++) send_one();
+  result->latencies_us.reserve(o.requests_per_client);
+  Response resp;
+  for (int num_received = 0; num_received < o.requests_per_client; num_received++) {
+    if (!client->ReadResponse(&resp)) {
+      result->ok = false;
+      return;
+    }
+    auto now = chrono::steady_clock::now();
+    result->latencies_us.push_back(
+        chrono::duration_cast<chrono::microseconds>(now - sent[resp.request_id]).count()
+    );
+    if (resp.status != kOk) result->errors++;
+    if (num_sent < o.requests_per_client) {
+      send_one();
+      num_sent++;
+    }
+  }
+}
+
+static void Usage(const char* argv0) {
+  fprintf(
+      stderr,
+      "Usage: %s [--socket PATH] [--clients N] [--requests N_PER_CLIENT] "
+      "[--pipeline N] [--size 44] [--seed N] [--op score|find|multi] "
+      "[--letters LETTERS]\n",
+      argv0
+  );
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 >= argc) {
+      Usage(argv[0]);
+      return 1;
+    }
+    const char* value = argv[++i];
+    if (arg == "--socket") {
+      o.socket_path = value;
+    } else if (arg == "--clients") {
+      o.num_clients = max(1, atoi(value));
+    } else if (arg == "--requests") {
+      o.requests_per_client = max(1, atoi(value));
+    } else if (arg == "--pipeline") {
+      o.pipeline = max(1, atoi(value));
+    } else if (arg == "--size") {
+      o.size = atoi(value);
+    } else if (arg == "--seed") {
+      o.seed = strtoull(value, NULL, 10);
+    } else if (arg == "--op") {
+      o.op = value;
+    } else if (arg == "--letters") {
+      o.letters = value;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (o.op != "score" && o.op != "find" && o.op != "multi") {
+    Usage(argv[0]);
+    return 1;
+  }
+  auto model = BoardModel::FromLetters(o.letters);
+  if (!model) return 1;
+
+  vector<ClientResult> results(o.num_clients);
+  vector<thread> threads;
+  auto start = chrono::steady_clock::now();
+  for (int i = 0; i < o.num_clients; i++) {
+    threads.emplace_back(RunClient, cref(o), cref(*model), i, &results[i]);
+  }
+  for (auto& t : threads) t.join();
+  double elapsed_s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  vector<uint64_t> latencies;
+  uint64_t errors = 0;
+  for (const auto& r : results) {
+    if (!r.ok) {
+      fprintf(stderr, "A client lost its connection\n");
+      return 1;
+    }
+    latencies.insert(latencies.end(), r.latencies_us.begin(), r.latencies_us.end());
+    errors += r.errors;
+  }
+  sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[min<size_t>(latencies.size() - 1, p * latencies.size())];
+  };
+
+  printf(
+      "%zu requests (%" PRIu64 " errors) in %.2fs: %.0f req/s\n",
+      latencies.size(),
+      errors,
+      elapsed_s,
+      latencies.size() / elapsed_s
+  );
+  printf(
+      "client latency: p50=%" PRIu64 "us p90=%" PRIu64 "us p99=%" PRIu64
+      "us p99.9=%" PRIu64 "us max=%" PRIu64 "us\n",
+      percentile(0.5),
+      percentile(0.9),
+      percentile(0.99),
+      percentile(0.999),
+      latencies.back()
+  );
+
+  auto client = BoggleClient::Connect(o.socket_path);
+  ServerStats s;
+  if (client && client->Stats(&s)) {
+    printf(
+        "server: requests=%" PRIu64 " batches=%" PRIu64 " queue=%" PRIu64
+        " (max %" PRIu64 ") latency p50=%" PRIu64 "us p90=%" PRIu64
+        "us p99=%" PRIu64 "us p99.9=%" PRIu64 "us max=%" PRIu64 "us\n",
+        s.requests,
+        s.batches,
+        s.queue_depth,
+        s.max_queue_depth,
+        s.p50_us,
+        s.p90_us,
+        s.p99_us,
+        s.p999_us,
+        s.max_us
+    );
+  }
+  return 0;
+}
@@ -0,0 +1,607 @@
+// A long-running scoring daemon. It loads a dictionary once and scores boards
+// for any number of local clients over a Unix domain socket. See
+// server_protocol.h for the wire format and boggle_client.h for a client.
+//
+//   ./boggle_server --dictionary wordlists/enable2k.txt --socket /tmp/boggle.sock
+//
+// The main thread owns all the connections. It reads requests, puts them on a
+// shared queue and writes out responses. Worker threads take batches of
+// requests off the queue (from whichever clients sent them) and score them
+// with their own ConcurrentBogglers, which can all share one Trie.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "concurrent_boggler.h"
+#include "server_protocol.h"
+#include "trie.h"
+
+using namespace std;
+using namespace server_protocol;
+
+// Limits on what one connection can make the server buffer. A connection
+// stops being read from while it is over either of the last two, so a client
+// that sends without reading its responses is held back rather than growing
+// them without bound. Any complete frame fits in the input limit.
+const size_t kMaxBufferedInput = 4 + kMaxFrameSize;
+const size_t kMaxBufferedOutput = 4 << 20;
+const size_t kMaxPendingRequests = 1024;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void HandleSignal(int) { g_stop = 1; }
+
+struct Options {
+  string dictionary = "wordlists/enable2k.txt";
+  string socket_path = "/tmp/boggle.sock";
+  int num_threads = 0;  // one per core
+  int batch_size = 64;
+  int stats_interval_s = 0;  // don't log stats
+};
+
+// Log-linear histogram of latencies in microseconds. Each power of two is split
+// into 8 buckets, so percentiles are accurate to within 12.5%.
+class LatencyHistogram {
+ public:
+  void Add(uint64_t us) {
+    counts_[Bucket(us)]++;
+    count_++;
+    max_ = max(max_, us);
+  }
+
+  void Merge(const LatencyHistogram& other) {
+    for (size_t b = 0; b < counts_.size(); b++) counts_[b] += other.counts_[b];
+    count_ += other.count_;
+    max_ = max(max_, other.max_);
+  }
+
+  // Returns the upper end of the bucket containing the p-th percentile.
+  uint64_t Percentile(double p) const {
+    uint64_t target = max<uint64_t>(1, p * count_);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < counts_.size(); b++) {
+      seen += counts_[b];
+      if (seen >= target) return min(BucketMax(b), max_);
+    }
+    return max_;
+  }
+
+  uint64_t Max() const { return max_; }
+
+ private:
+  static int Bucket(uint64_t v) {
+    if (v < 8) return v;
+    int msb = 63 - __builtin_clzll(v);
+    return (msb - 2) * 8 + ((v >> (msb - 3)) & 7);
+  }
+
+  static uint64_t BucketMax(int b) {
+    if (b < 8) return b;
+    int msb = b / 8 + 2;
+    return ((uint64_t(8 + b % 8 + 1)) << (msb - 3)) - 1;
+  }
+
+  array<uint64_t, 64 * 8> counts_{};
+  uint64_t count_ = 0;
+  uint64_t max_ = 0;
+};
+
+// A ConcurrentBoggler for each supported board size, created on first use.
+class SizedBogglers {
+ public:
+  SizedBogglers(const Trie* t) : dict_(t) {}
+
+  // Returns false if the request is for an unsupported size or invalid board.
+  bool Handle(const Request& req, string* payload) {
+    if (req.width < 2 || req.width > 5 || req.height < 2 || req.height > 5) {
+      return false;
+    }
+    switch (req.width * 10 + req.height) {
+      case 22: return Handle(b22_, req, payload);
+      case 23: return Handle(b23_, req, payload);
+      case 33: return Handle(b33_, req, payload);
+      case 34: return Handle(b34_, req, payload);
+      case 44: return Handle(b44_, req, payload);
+      case 45: return Handle(b45_, req, payload);
+      case 55: return Handle(b55_, req, payload);
+    }
+    return false;
+  }
+
+ private:
+  template <int M, int N>
+  bool Handle(
+      unique_ptr<ConcurrentBoggler<M, N>>& b, const Request& req, string* payload
+  ) {
+    // Checked here so that bad boards from clients don't fill the log.
+    if (!IsValidBoardString(req.board, M * N)) return false;
+    if (!b) b.reset(new ConcurrentBoggler<M, N>(dict_));
+    if (req.op == kScore) {
+      int score = b->Score(req.board.c_str());
+      if (score < 0) return false;
+      PutU32(payload, score);
+    } else {
+      auto paths = b->FindWords(req.board, req.flags & kMultiboggle);
+      if (paths.size() == 1 && paths[0].size() == 1 && paths[0][0] == -1) return false;
+      EncodePaths(paths, payload);
+    }
+    return true;
+  }
+
+  const Trie* dict_;
+  unique_ptr<ConcurrentBoggler<2, 2>> b22_;
+  unique_ptr<ConcurrentBoggler<2, 3>> b23_;
+  unique_ptr<ConcurrentBoggler<3, 3>> b33_;
+  unique_ptr<ConcurrentBoggler<3, 4>> b34_;
+  unique_ptr<ConcurrentBoggler<4, 4>> b44_;
+  unique_ptr<ConcurrentBoggler<4, 5>> b45_;
+  unique_ptr<ConcurrentBoggler<5, 5>> b55_;
+};
+
+// Makes fd non-blocking and close-on-exec. (SOCK_NONBLOCK and accept4 do this
+// in one step, but they're Linux-only.)
+static bool SetNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+         fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+class Server {
+ public:
+  Server(const Trie* t, const Options& options) : dict_(t), options_(options) {}
+
+  // Returns false (and logs) if the socket can't be set up.
+  bool Listen();
+  // Serves until SIGINT or SIGTERM.
+  void Run();
+
+ private:
+  struct Connection {
+    int fd;
+    string in;
+    string out;
+    // Requests that have been queued but whose responses aren't in out yet.
+    size_t num_pending = 0;
+
+    bool Backlogged() const {
+      return out.size() >= kMaxBufferedOutput || num_pending >= kMaxPendingRequests;
+    }
+  };
+
+  struct PendingRequest {
+    uint64_t conn_id;
+    Request req;
+    chrono::steady_clock::time_point received;
+  };
+
+  // Each worker only contends with Stats() for its own stats.
+  struct WorkerStats {
+    mutex mu;
+    LatencyHistogram latency;
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+  };
+
+  void WorkerLoop(int index);
+  void Accept();
+  // These return false if the connection should be closed.
+  bool ReadRequests(uint64_t conn_id, Connection& conn);
+  // Queues or answers the complete frames in conn.in, until it's backlogged.
+  bool ParseRequests(uint64_t conn_id, Connection& conn);
+  bool WriteResponses(Connection& conn);
+  void CollectResponses();
+  ServerStats Stats();
+  void LogStats();
+
+  const Trie* dict_;
+  Options options_;
+  int listen_fd_ = -1;
+  // A pipe that workers write to when responses are ready.
+  int wake_read_fd_ = -1;
+  int wake_write_fd_ = -1;
+
+  // Only touched by the main thread.
+  unordered_map<uint64_t, Connection> conns_;
+  uint64_t next_conn_id_ = 0;
+
+  mutex queue_mutex_;
+  condition_variable queue_cv_;
+  deque<PendingRequest> queue_;
+  uint64_t max_queue_depth_ = 0;
+  bool stopping_ = false;
+
+  // Encoded responses, by connection id.
+  mutex done_mutex_;
+  vector<pair<uint64_t, string>> done_;
+
+  vector<thread> workers_;
+  vector<unique_ptr<WorkerStats>> worker_stats_;
+};
+
+bool Server::Listen() {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (options_.socket_path.size() >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "Socket path is too long: %s\n", options_.socket_path.c_str());
+    return false;
+  }
+  strcpy(addr.sun_path, options_.socket_path.c_str());
+  unlink(addr.sun_path);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0 || !SetNonBlocking(listen_fd_) ||
+      bind(listen_fd_, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(listen_fd_, 128) != 0) {
+    perror(("Couldn't listen on " + options_.socket_path).c_str());
+    return false;
+  }
+  int wake_fds[2];
+  if (pipe(wake_fds) != 0 || !SetNonBlocking(wake_fds[0]) ||
+      !SetNonBlocking(wake_fds[1])) {
+    perror("pipe");
+    return false;
+  }
+  wake_read_fd_ = wake_fds[0];
+  wake_write_fd_ = wake_fds[1];
+  return true;
+}
+
+void Server::Run() {
+  int num_threads = options_.num_threads;
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  for (int i = 0; i < num_threads; i++) {
+    worker_stats_.emplace_back(new WorkerStats);
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&Server::WorkerLoop, this, i);
+  }
+  fprintf(
+      stderr,
+      "Listening on %s with %d threads (batches of up to %d)\n",
+      options_.socket_path.c_str(),
+      num_threads,
+      options_.batch_size
+  );
+
+  auto last_log = chrono::steady_clock::now();
+  vector<pollfd> fds;
+  vector<uint64_t> fd_conns;
+  while (!g_stop) {
+    fds.clear();
+    fd_conns.clear();
+    fds.push_back({listen_fd_, POLLIN, 0});
+    fds.push_back({wake_read_fd_, POLLIN, 0});
+    for (const auto& [id, conn] : conns_) {
+      short events = (conn.Backlogged() ? 0 : POLLIN) | (conn.out.empty() ? 0 : POLLOUT);
+      fds.push_back({conn.fd, events, 0});
+      fd_conns.push_back(id);
+    }
+    int n = poll(fds.data(), fds.size(), 1000);
+    if (n < 0 && errno != EINTR) {
+      perror("poll");
+      break;
+    }
+
+    if (n > 0) {
+      if (fds[0].revents & POLLIN) Accept();
+      if (fds[1].revents & POLLIN) CollectResponses();
+      for (size_t i = 2; i < fds.size(); i++) {
+        uint64_t id = fd_conns[i - 2];
+        auto it = conns_.find(id);
+        if (it == conns_.end()) continue;
+        Connection& conn = it->second;
+        short revents = fds[i].revents;
+        bool ok = !(revents & POLLERR);
+        if (ok && (revents & (POLLIN | POLLHUP))) {
+          // A backlogged client that has hung up can't take its responses.
+          ok = conn.Backlogged() ? !(revents & POLLHUP) : ReadRequests(id, conn);
+        }
+        if (ok && !conn.out.empty()) ok = WriteResponses(conn);
+        // Pick up frames that arrived while the connection was backlogged.
+        if (ok && !conn.in.empty()) ok = ParseRequests(id, conn);
+        if (!ok) {
+          close(conn.fd);
+          conns_.erase(it);
+        }
+      }
+    }
+
+    if (options_.stats_interval_s > 0 &&
+        chrono::steady_clock::now() - last_log >= chrono::seconds(options_.stats_interval_s)) {
+      LogStats();
+      last_log = chrono::steady_clock::now();
+    }
+  }
+
+  fprintf(stderr, "Shutting down\n");
+  {
+    lock_guard<mutex> lock(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& w : workers_) w.join();
+  LogStats();
+  for (auto& [id, conn] : conns_) close(conn.fd);
+  close(listen_fd_);
+  close(wake_read_fd_);
+  close(wake_write_fd_);
+  unlink(options_.socket_path.c_str());
+}
+
+void Server::Accept() {
+  while (true) {
+    int fd = accept(listen_fd_, NULL, NULL);
+    if (fd < 0) return;
+    if (!SetNonBlocking(fd)) {
+      close(fd);
+      continue;
+    }
+    conns_[next_conn_id_++] = {fd, "", "", 0};
+  }
+}
+
+bool Server::ReadRequests(uint64_t conn_id, Connection& conn) {
+  char buf[65536];
+  // If this stops short, poll will report the rest.
+  while (conn.in.size() < kMaxBufferedInput) {
+    ssize_t n = read(conn.fd, buf, sizeof(buf));
+    if (n > 0) {
+      conn.in.append(buf, n);
+      continue;
+    }
+    if (n == 0) return false;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+    if (errno == EINTR) continue;
+    return false;
+  }
+  return ParseRequests(conn_id, conn);
+}
+
+bool Server::ParseRequests(uint64_t conn_id, Connection& conn) {
+  auto now = chrono::steady_clock::now();
+  vector<PendingRequest> requests;
+  size_t pos = 0;
+  while (!conn.Backlogged()) {
+    const char* body;
+    int64_t size = NextFrame(conn.in.data() + pos, conn.in.size() - pos, kRequestHeaderSize, &body);
+    if (size < 0) {
+      fprintf(
+          stderr, "Closing connection %" PRIu64 " after a malformed frame\n", conn_id
+      );
+      return false;
+    }
+    if (size == 0) break;
+    PendingRequest p{conn_id, {}, now};
+    DecodeRequest(body, size - 4, &p.req);
+    pos += size;
+
+    // Stats and bad ops are answered right away; everything else is queued.
+    if (p.req.op == kStats || (p.req.op != kScore && p.req.op != kFindWords)) {
+      Response resp;
+      resp.request_id = p.req.request_id;
+      resp.op = p.req.op;
+      if (p.req.op == kStats) {
+        EncodeStats(Stats(), &resp.payload);
+      } else {
+        resp.status = kBadRequest;
+      }
+      EncodeResponse(resp, &conn.out);
+      continue;
+    }
+    requests.push_back(move(p));
+    conn.num_pending++;
+  }
+  conn.in.erase(0, pos);
+
+  if (!requests.empty()) {
+    {
+      lock_guard<mutex> lock(queue_mutex_);
+      for (auto& p : requests) queue_.push_back(move(p));
+      max_queue_depth_ = max<uint64_t>(max_queue_depth_, queue_.size());
+    }
+    queue_cv_.notify_all();
+  }
+  return true;
+}
+
+bool Server::WriteResponses(Connection& conn) {
+  while (!conn.out.empty()) {
+    ssize_t n = send(conn.fd, conn.out.data(), conn.out.size(), 0);
+    if (n > 0) {
+      conn.out.erase(0, n);
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (n < 0 && errno == EINTR) continue;
+    return false;
+  }
+  return true;
+}
+
+void Server::CollectResponses() {
+  // Drain the pipe. Each worker's wakeup is for whatever is in done_ by now.
+  char buf[256];
+  while (read(wake_read_fd_, buf, sizeof(buf)) > 0) {
+  }
+  vector<pair<uint64_t, string>> done;
+  {
+    lock_guard<mutex> lock(done_mutex_);
+    done.swap(done_);
+  }
+  for (auto& [id, bytes] : done) {
+    auto it = conns_.find(id);
+    if (it == conns_.end()) continue;  // the client left
+    it->second.out.append(bytes);
+    it->second.num_pending--;
+  }
+}
+
+void Server::WorkerLoop(int index) {
+  SizedBogglers bogglers(dict_);
+  WorkerStats& stats = *worker_stats_[index];
+  int num_threads = worker_stats_.size();
+  vector<PendingRequest> batch;
+  while (true) {
+    batch.clear();
+    {
+      unique_lock<mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) return;  // stopping
+      // Take an even share of the queue (up to the batch size), so that a short
+      // queue is spread across threads rather than handled by one.
+      size_t share = (queue_.size() + num_threads - 1) / num_threads;
+      size_t n = min<size_t>(options_.batch_size, share);
+      for (size_t i = 0; i < n; i++) {
+        batch.push_back(move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+
+    vector<pair<uint64_t, string>> responses;
+    vector<uint64_t> latencies;
+    for (const auto& p : batch) {
+      Response resp;
+      resp.request_id = p.req.request_id;
+      resp.op = p.req.op;
+      if (!bogglers.Handle(p.req, &resp.payload)) {
+        resp.status = kBadRequest;
+        resp.payload.clear();
+      }
+      string bytes;
+      EncodeResponse(resp, &bytes);
+      responses.emplace_back(p.conn_id, move(bytes));
+      auto elapsed = chrono::steady_clock::now() - p.received;
+      latencies.push_back(chrono::duration_cast<chrono::microseconds>(elapsed).count());
+    }
+
+    // Record stats first, so that a client that has its responses sees them.
+    {
+      lock_guard<mutex> lock(stats.mu);
+      for (uint64_t us : latencies) stats.latency.Add(us);
+      stats.requests += batch.size();
+      stats.batches++;
+    }
+    {
+      lock_guard<mutex> lock(done_mutex_);
+      for (auto& r : responses) done_.push_back(move(r));
+    }
+    // If the pipe is full, the main thread has wakeups to read already.
+    char one = 1;
+    if (write(wake_write_fd_, &one, 1) < 0 && errno != EAGAIN) {
+      perror("wakeup write");
+    }
+  }
+}
+
+ServerStats Server::Stats() {
+  ServerStats s;
+  LatencyHistogram latency;
+  for (auto& ws : worker_stats_) {
+    lock_guard<mutex> lock(ws->mu);
+    latency.Merge(ws->latency);
+    s.requests += ws->requests;
+    s.batches += ws->batches;
+  }
+  {
+    lock_guard<mutex> lock(queue_mutex_);
+    s.queue_depth = queue_.size();
+    s.max_queue_depth = max_queue_depth_;
+  }
+  s.p50_us = latency.Percentile(0.5);
+  s.p90_us = latency.Percentile(0.9);
+  s.p99_us = latency.Percentile(0.99);
+  s.p999_us = latency.Percentile(0.999);
+  s.max_us = latency.Max();
+  return s;
+}
+
+void Server::LogStats() {
+  ServerStats s = Stats();
+  fprintf(
+      stderr,
+      "requests=%" PRIu64 " batches=%" PRIu64 " (%.1f per batch) queue=%" PRIu64
+      " (max %" PRIu64 ") latency p50=%" PRIu64 "us p90=%" PRIu64 "us p99=%" PRIu64
+      "us p99.9=%" PRIu64 "us max=%" PRIu64 "us\n",
+      s.requests,
+      s.batches,
+      s.batches ? double(s.requests) / s.batches : 0.0,
+      s.queue_depth,
+      s.max_queue_depth,
+      s.p50_us,
+      s.p90_us,
+      s.p99_us,
+      s.p999_us,
+      s.max_us
+  );
+}
+
+static void Usage(const char* argv0) {
+  fprintf(
+      stderr,
+      "Usage: %s [--dictionary FILE] [--socket PATH] [--threads N] "
+      "[--batch_size N] [--stats_interval SECONDS]\n",
+      argv0
+  );
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if (i + 1 >= argc) {
+      Usage(argv[0]);
+      return 1;
+    }
+    const char* value = argv[++i];
+    if (arg == "--dictionary") {
+      options.dictionary = value;
+    } else if (arg == "--socket") {
+      options.socket_path = value;
+    } else if (arg == "--threads") {
+      options.num_threads = atoi(value);
+    } else if (arg == "--batch_size") {
+      options.batch_size = max(1, atoi(value));
+    } else if (arg == "--stats_interval") {
+      options.stats_interval_s = atoi(value);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  unique_ptr<Trie> t = Trie::CreateFromFileBulk(options.dictionary.c_str(), 0);
+  if (!t) return 1;
+
+  struct sigaction sa = {};
+  sa.sa_handler = HandleSignal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  // A client that hangs up shows up as an error from send() instead.
+  sa.sa_handler = SIG_IGN;
+  sigaction(SIGPIPE, &sa, NULL);
+
+  Server server(t.get(), options);
+  if (!server.Listen()) return 1;
+  server.Run();
+  return 0;
+}
@@ -2,12 +2,56 @@
 #ifndef BOGGLER_4
 #define BOGGLER_4
 
+#include <cstdio>
+#include <cstring>
 #include <unordered_set>
 
 #include "neighbors.h"
 #include "constants.h"
 #include "trie.h"
 
+// True if ParseBoardString would accept bd. This doesn't log anything, so it's
+// the one to use on boards from untrusted clients.
+inline bool IsValidBoardString(const string& bd, unsigned int expected_len) {
+  if (bd.size() != expected_len) return false;
+  for (char c : bd) {
+    if (c != '.' && (c < 'a' || c > 'z')) return false;
+  }
+  return true;
+}
+
+// Parses a board string into 0-25 letter codes, writing expected_len cells.
+// '.' becomes -1 (explicit "do not go here"). Returns false and logs to stderr
+// on invalid input.
+inline bool ParseBoardString(const char* bd, int* cells, unsigned int expected_len) {
+  if (strlen(bd) != expected_len) {
+    fprintf(
+        stderr,
+        "Board strings must contain %d characters, got %zu ('%s')\n",
+        expected_len,
+        strlen(bd),
+        bd
+    );
+    return false;
+  }
+
+  for (unsigned int i = 0; i < expected_len; i++) {
+    if (bd[i] == '.') {
+      cells[i] = -1;  // explicit "do not go here"; only supported by FindWords()
+      continue;
+    }
+    if (bd[i] >= 'A' && bd[i] <= 'Z') {
+      fprintf(stderr, "Found uppercase letter '%c'\n", bd[i]);
+      return false;
+    } else if (bd[i] < 'a' || bd[i] > 'z') {
+      fprintf(stderr, "Found unexpected letter: '%c'\n", bd[i]);
+      return false;
+    }
+    cells[i] = bd[i] - 'a';
+  }
+  return true;
+}
+
 template <int M, int N>
 class Boggler {
  public:
@@ -20,6 +64,21 @@ class Boggler {
 
   int Score(const char* lets);
 
+  // Like Score(), but also works out how much each cell contributes:
+  // cell_scores[i] is the total score of the words whose path uses cell i and
+  // cell_words[i] is the number of such words. Each word is credited to the
+  // first path on which it's found. Both arrays must have M * N entries.
+  // Returns -1 for an invalid board.
+  int ScoreWithAttribution(const char* lets, int* cell_scores, int* cell_words);
+
+  // Like Score(), but skips the parts of the Trie whose nearest word needs
+  // more letters than there are free cells left (see Trie::MinRemaining).
+  // Near the end of a path on a small board, that's most of them.
+  int ScorePruned(const char* lets);
+  // Score() or ScorePruned(), also setting *visits to the number of Trie nodes
+  // visited. Counting makes this slower than either, so don't time it.
+  int ScoreCountingVisits(const char* lets, bool prune, uint64_t* visits);
+
   unsigned int NumCells() { return M * N; }
 
   // Set a cell on the current board. Must have 0 <= x < M, 0 <= y < N and 0 <=
@@ -31,10 +90,15 @@ class Boggler {
   vector<vector<int>> FindWords(const string& lets, bool multiboggle);
 
  private:
+  template <bool kPrune>
   void DoDFS(unsigned int i, unsigned int len, Trie* t);
+  void AttributionDFS(unsigned int i, unsigned int len, Trie* t);
+  template <bool kPrune>
+  void VisitsDFS(unsigned int i, unsigned int len, Trie* t);
   void FindWordsDFS(
       unsigned int i, Trie* t, bool multiboggle, vector<vector<int>>& out
   );
+  template <bool kPrune>
   unsigned int InternalScore();
   bool ParseBoard(const char* bd);
 
@@ -43,6 +107,9 @@ class Boggler {
   int bd_[M * N];
   unsigned int score_;
   unsigned int runs_;
+  int* cell_scores_;
+  int* cell_words_;
+  uint64_t visits_;
   vector<int> seq_;
   unordered_set<uint64_t> found_words_;
 };
@@ -62,41 +129,133 @@ int Boggler<M, N>::Score(const char* lets) {
   if (!ParseBoard(lets)) {
     return -1;
   }
-  return InternalScore();
+  return InternalScore<false>();
 }
 
 template <int M, int N>
-bool Boggler<M, N>::ParseBoard(const char* bd) {
-  unsigned int expected_len = M * N;
-  if (strlen(bd) != expected_len) {
-    fprintf(
-        stderr,
-        "Board strings must contain %d characters, got %zu ('%s')\n",
-        expected_len,
-        strlen(bd),
-        bd
-    );
-    return false;
+int Boggler<M, N>::ScoreWithAttribution(
+    const char* lets, int* cell_scores, int* cell_words
+) {
+  if (!ParseBoard(lets)) {
+    return -1;
+  }
+  cell_scores_ = cell_scores;
+  cell_words_ = cell_words;
+  for (int i = 0; i < M * N; i++) {
+    cell_scores[i] = cell_words[i] = 0;
   }
 
-  for (unsigned int i = 0; i < expected_len; i++) {
-    if (bd[i] == '.') {
-      bd_[i] = -1;  // explicit "do not go here"; only supported by FindWords()
-      continue;
+  runs_ = dict_->Mark() + 1;
+  dict_->Mark(runs_);
+  used_ = 0;
+  score_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (dict_->StartsWord(c)) AttributionDFS(i, 0, dict_->Descend(c));
+  }
+  return score_;
+}
+
+// This is DoDFS plus a loop over the cells of each newly found word's path.
+// Words are rare compared to DFS steps, so this costs little extra.
+template <int M, int N>
+void Boggler<M, N>::AttributionDFS(unsigned int i, unsigned int len, Trie* t) {
+  int c = bd_[i];
+  used_ ^= (1 << i);
+  len += (c == kQ ? 2 : 1);
+  if (t->IsWord() && t->Mark() != runs_) {
+    t->Mark(runs_);
+    unsigned int points = kWordScores[len];
+    score_ += points;
+    for (unsigned int path = used_; path; path &= path - 1) {
+      int cell = __builtin_ctz(path);
+      cell_scores_[cell] += points;
+      cell_words_[cell]++;
     }
-    if (bd[i] >= 'A' && bd[i] <= 'Z') {
-      fprintf(stderr, "Found uppercase letter '%c'\n", bd[i]);
-      return false;
-    } else if (bd[i] < 'a' || bd[i] > 'z') {
-      fprintf(stderr, "Found unexpected letter: '%c'\n", bd[i]);
-      return false;
+  }
+
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (t->StartsWord(cc)) {
+        AttributionDFS(idx, len, t->Descend(cc));
+      }
     }
-    bd_[i] = bd[i] - 'a';
+  });
+
+  used_ ^= (1 << i);
+}
+
+template <int M, int N>
+int Boggler<M, N>::ScorePruned(const char* lets) {
+  if (!ParseBoard(lets)) {
+    return -1;
   }
-  return true;
+  return InternalScore<true>();
+}
+
+template <int M, int N>
+int Boggler<M, N>::ScoreCountingVisits(
+    const char* lets, bool prune, uint64_t* visits
+) {
+  *visits = 0;
+  if (!ParseBoard(lets)) {
+    return -1;
+  }
+  runs_ = dict_->Mark() + 1;
+  dict_->Mark(runs_);
+  used_ = 0;
+  score_ = 0;
+  visits_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (!dict_->StartsWord(c)) continue;
+    if (prune) {
+      VisitsDFS<true>(i, 0, dict_->Descend(c));
+    } else {
+      VisitsDFS<false>(i, 0, dict_->Descend(c));
+    }
+  }
+  *visits = visits_;
+  return score_;
+}
+
+template <int M, int N>
+template <bool kPrune>
+void Boggler<M, N>::VisitsDFS(unsigned int i, unsigned int len, Trie* t) {
+  int c = bd_[i];
+  visits_++;
+  used_ ^= (1 << i);
+  len += (c == kQ ? 2 : 1);
+  if (t->IsWord() && t->Mark() != runs_) {
+    t->Mark(runs_);
+    score_ += kWordScores[len];
+  }
+
+  // Same pruning as DoDFS<true>.
+  int free_cells = M * N - __builtin_popcount(used_);
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (t->StartsWord(cc)) {
+        Trie* child = t->Descend(cc);
+        if (!kPrune || child->MinRemaining() < free_cells) {
+          VisitsDFS<kPrune>(idx, len, child);
+        }
+      }
+    }
+  });
+
+  used_ ^= (1 << i);
+}
+
+template <int M, int N>
+bool Boggler<M, N>::ParseBoard(const char* bd) {
+  return ParseBoardString(bd, bd_, M * N);
 }
 
 template <int M, int N>
+template <bool kPrune>
 unsigned int Boggler<M, N>::InternalScore() {
   runs_ = dict_->Mark() + 1;
   dict_->Mark(runs_);
@@ -104,19 +263,24 @@ unsigned int Boggler<M, N>::InternalScore() {
   score_ = 0;
   for (int i = 0; i < M * N; i++) {
     int c = bd_[i];
-    if (dict_->StartsWord(c)) DoDFS(i, 0, dict_->Descend(c));
+    if (dict_->StartsWord(c)) DoDFS<kPrune>(i, 0, dict_->Descend(c));
   }
   return score_;
 }
 
-#define REC(idx)                         \
-  do {                                   \
-    if ((used_ & (1 << idx)) == 0) {     \
-      cc = bd_[idx];                     \
-      if (t->StartsWord(cc)) {           \
-        DoDFS(idx, len, t->Descend(cc)); \
-      }                                  \
-    }                                    \
+// With kPrune, going to a neighbor takes one of the free cells, so a child is
+// only worth visiting if its nearest word needs fewer letters than that.
+#define REC(idx)                                             \
+  do {                                                       \
+    if ((used_ & (1 << idx)) == 0) {                         \
+      cc = bd_[idx];                                         \
+      if (t->StartsWord(cc)) {                               \
+        Trie* child = t->Descend(cc);                        \
+        if (!kPrune || child->MinRemaining() < free_cells) { \
+          DoDFS<kPrune>(idx, len, child);                    \
+        }                                                    \
+      }                                                      \
+    }                                                        \
   } while (0)
 
 #define REC3(a, b, c) \
@@ -134,15 +298,16 @@ unsigned int Boggler<M, N>::InternalScore() {
   REC3(f, g, h)
 
 // PREFIX and SUFFIX could be inline methods instead, but this incurs a ~5% perf hit.
-#define PREFIX()                  \
-  int c = bd_[i], cc;             \
-  used_ ^= (1 << i);              \
-  len += (c == kQ ? 2 : 1);       \
-  if (t->IsWord()) {              \
-    if (t->Mark() != runs_) {     \
-      t->Mark(runs_);             \
-      score_ += kWordScores[len]; \
-    }                             \
+#define PREFIX()                                                        \
+  int c = bd_[i], cc;                                                   \
+  used_ ^= (1 << i);                                                    \
+  int free_cells = kPrune ? NumCells() - __builtin_popcount(used_) : 0; \
+  len += (c == kQ ? 2 : 1);                                             \
+  if (t->IsWord()) {                                                    \
+    if (t->Mark() != runs_) {                                           \
+      t->Mark(runs_);                                                   \
+      score_ += kWordScores[len];                                       \
+    }                                                                   \
   }
 
 #define SUFFIX() used_ ^= (1 << i)
@@ -156,6 +321,7 @@ for (w, h), neighbors in NEIGHBORS.items():
     print(f"""
 // {w}x{h}
 template<>
+template<bool kPrune>
 void Boggler<{w}, {h}>::DoDFS(unsigned int i, unsigned int len, Trie* t) {{
   PREFIX();
   switch(i) {{""")
@@ -170,6 +336,7 @@ void Boggler<{w}, {h}>::DoDFS(unsigned int i, unsigned int len, Trie* t) {{
 
 // 2x2
 template<>
+template<bool kPrune>
 void Boggler<2, 2>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -183,6 +350,7 @@ void Boggler<2, 2>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 2x3
 template<>
+template<bool kPrune>
 void Boggler<2, 3>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -198,6 +366,7 @@ void Boggler<2, 3>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 3x3
 template<>
+template<bool kPrune>
 void Boggler<3, 3>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -216,6 +385,7 @@ void Boggler<3, 3>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 3x4
 template<>
+template<bool kPrune>
 void Boggler<3, 4>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -237,6 +407,7 @@ void Boggler<3, 4>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 4x4
 template<>
+template<bool kPrune>
 void Boggler<4, 4>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -262,6 +433,7 @@ void Boggler<4, 4>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 4x5
 template<>
+template<bool kPrune>
 void Boggler<4, 5>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
@@ -291,6 +463,7 @@ void Boggler<4, 5>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
 
 // 5x5
 template<>
+template<bool kPrune>
 void Boggler<5, 5>::DoDFS(unsigned int i, unsigned int len, Trie* t) {
   PREFIX();
   switch(i) {
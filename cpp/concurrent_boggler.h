@@ -0,0 +1,213 @@
+// Solver for MxN Boggle that doesn't write to the Trie.
+#ifndef CONCURRENT_BOGGLER_H
+#define CONCURRENT_BOGGLER_H
+
+#include <unordered_set>
+#include <vector>
+
+#include "boggler.h"
+#include "constants.h"
+#include "neighbors.h"
+#include "trie.h"
+
+// Boggler dedupes words using marks on the Trie nodes, so only one Boggler can
+// use a Trie at a time. This one keeps its marks in a table indexed by word id
+// instead, so any number of ConcurrentBogglers (e.g. one per thread) can share
+// a Trie. The table is a little slower than marking nodes.
+template <int M, int N>
+class ConcurrentBoggler {
+ public:
+  ConcurrentBoggler(const Trie* t) : dict_(t), runs_(0) {
+    marks_.resize(t->MaxWordId() + 1, 0);
+  }
+
+  // Returns -1 for an invalid board.
+  int Score(const char* lets) {
+    if (!ParseBoardString(lets, bd_, M * N)) return -1;
+    return InternalScore();
+  }
+
+  // Adds 1 to hits[id] for each word on the board and adds the number of
+  // distinct paths (sequences of cells) that spell it to paths[id]. Both
+  // arrays need NumWordIds() entries. Returns false for an invalid board.
+  bool CountWords(const char* lets, uint64_t* hits, uint64_t* paths);
+
+  // Same as Boggler::FindWords.
+  vector<vector<int>> FindWords(const string& lets, bool multiboggle);
+
+  // Switch to a different dictionary for subsequent boards.
+  void SetTrie(const Trie* t) {
+    dict_ = t;
+    marks_.resize(max<size_t>(marks_.size(), t->MaxWordId() + 1), 0);
+  }
+
+  unsigned int NumCells() { return M * N; }
+  size_t NumWordIds() const { return marks_.size(); }
+
+ private:
+  unsigned int InternalScore();
+  void NextRun();
+  void DoDFS(unsigned int i, unsigned int len, const Trie* t);
+  void CountDFS(unsigned int i, const Trie* t);
+  void FindWordsDFS(
+      unsigned int i, const Trie* t, bool multiboggle, vector<vector<int>>& out
+  );
+
+  const Trie* dict_;
+  vector<uint32_t> marks_;  // marks_[word_id] == runs_ if found on this board
+  unsigned int used_;
+  int bd_[M * N];
+  unsigned int score_;
+  uint32_t runs_;
+  uint64_t* hits_;
+  uint64_t* paths_;
+  vector<int> seq_;
+  unordered_set<uint64_t> found_words_;
+};
+
+template <int M, int N>
+void ConcurrentBoggler<M, N>::NextRun() {
+  if (++runs_ == 0) {
+    fill(marks_.begin(), marks_.end(), 0);
+    runs_ = 1;
+  }
+}
+
+template <int M, int N>
+unsigned int ConcurrentBoggler<M, N>::InternalScore() {
+  NextRun();
+  used_ = 0;
+  score_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (c != -1 && dict_->StartsWord(c)) DoDFS(i, 0, dict_->Descend(c));
+  }
+  return score_;
+}
+
+template <int M, int N>
+void ConcurrentBoggler<M, N>::DoDFS(unsigned int i, unsigned int len, const Trie* t) {
+  int c = bd_[i];
+  used_ ^= (1 << i);
+  len += (c == kQ ? 2 : 1);
+  if (t->IsWord()) {
+    uint32_t& mark = marks_[t->WordId()];
+    if (mark != runs_) {
+      mark = runs_;
+      score_ += kWordScores[len];
+    }
+  }
+
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (cc != -1 && t->StartsWord(cc)) {
+        DoDFS(idx, len, t->Descend(cc));
+      }
+    }
+  });
+
+  used_ ^= (1 << i);
+}
+
+template <int M, int N>
+bool ConcurrentBoggler<M, N>::CountWords(
+    const char* lets, uint64_t* hits, uint64_t* paths
+) {
+  if (!ParseBoardString(lets, bd_, M * N)) return false;
+  NextRun();
+  hits_ = hits;
+  paths_ = paths;
+  used_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (c != -1 && dict_->StartsWord(c)) CountDFS(i, dict_->Descend(c));
+  }
+  return true;
+}
+
+// Unlike DoDFS, this visits every path to a word, not just the first.
+template <int M, int N>
+void ConcurrentBoggler<M, N>::CountDFS(unsigned int i, const Trie* t) {
+  used_ ^= (1 << i);
+  if (t->IsWord()) {
+    uint32_t id = t->WordId();
+    paths_[id]++;
+    if (marks_[id] != runs_) {
+      marks_[id] = runs_;
+      hits_[id]++;
+    }
+  }
+
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (cc != -1 && t->StartsWord(cc)) {
+        CountDFS(idx, t->Descend(cc));
+      }
+    }
+  });
+
+  used_ ^= (1 << i);
+}
+
+template <int M, int N>
+vector<vector<int>> ConcurrentBoggler<M, N>::FindWords(
+    const string& lets, bool multiboggle
+) {
+  found_words_.clear();
+  seq_.clear();
+  seq_.reserve(M * N);
+  vector<vector<int>> out;
+  if (!ParseBoardString(lets.c_str(), bd_, M * N)) {
+    out.push_back({-1});
+    return out;
+  }
+
+  NextRun();
+  used_ = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (c != -1 && dict_->StartsWord(c)) {
+      FindWordsDFS(i, dict_->Descend(c), multiboggle, out);
+    }
+  }
+  return out;
+}
+
+template <int M, int N>
+void ConcurrentBoggler<M, N>::FindWordsDFS(
+    unsigned int i, const Trie* t, bool multiboggle, vector<vector<int>>& out
+) {
+  used_ ^= (1 << i);
+  seq_.push_back(i);
+  if (t->IsWord()) {
+    bool should_count;
+    if (multiboggle) {
+      uint64_t key = (((uint64_t)t->WordId()) << 32) + used_;
+      should_count = found_words_.emplace(key).second;
+    } else {
+      uint32_t& mark = marks_[t->WordId()];
+      should_count = (mark != runs_);
+      mark = runs_;
+    }
+    if (should_count) out.push_back(seq_);
+  }
+
+  auto& neighbors = Neighbors<M, N>::NEIGHBORS[i];
+  auto n_neighbors = neighbors[0];
+  for (int j = 1; j <= n_neighbors; j++) {
+    auto idx = neighbors[j];
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (cc != -1 && t->StartsWord(cc)) {
+        FindWordsDFS(idx, t->Descend(cc), multiboggle, out);
+      }
+    }
+  }
+
+  used_ ^= (1 << i);
+  seq_.pop_back();
+}
+
+#endif  // CONCURRENT_BOGGLER_H
@@ -12,7 +12,9 @@ const unsigned int kWordScores[] = {
 
 // 5x5 board, 26 letters.
 const int MAX_CELLS = 5 * 5;
-const int MAX_STACK_DEPTH = MAX_CELLS * 26;
+// A path through the board uses each cell at most once, so a DFS needs at
+// most one stack frame per cell (see IterativeBoggler).
+const int MAX_STACK_DEPTH = MAX_CELLS;
 
 // clang-format on
 
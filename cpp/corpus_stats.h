@@ -0,0 +1,78 @@
+// Word statistics over a large batch of boards.
+#ifndef CORPUS_STATS_H
+#define CORPUS_STATS_H
+
+#include <stdint.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_boggler.h"
+#include "trie.h"
+
+using namespace std;
+
+struct CorpusWordStats {
+  uint64_t num_boards = 0;
+  uint64_t num_invalid = 0;  // boards that couldn't be parsed
+  // Both of these are indexed by word id.
+  vector<uint64_t> hits;   // number of boards on which the word appears
+  vector<uint64_t> paths;  // total number of paths that spell it
+};
+
+// Finds the words on each board of a batch across several threads. Each thread
+// counts into its own arrays, which are summed at the end.
+template <int M, int N>
+class CorpusAnalyzer {
+ public:
+  CorpusAnalyzer(const Trie* t) : dict_(t) {}
+
+  // num_threads=0 means one per core.
+  CorpusWordStats Analyze(const vector<string>& boards, int num_threads);
+
+ private:
+  const Trie* dict_;
+};
+
+template <int M, int N>
+CorpusWordStats CorpusAnalyzer<M, N>::Analyze(
+    const vector<string>& boards, int num_threads
+) {
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  num_threads = max(1, min<int>(num_threads, boards.size()));
+
+  vector<CorpusWordStats> partials(num_threads);
+  vector<thread> threads;
+  for (int ti = 0; ti < num_threads; ti++) {
+    threads.emplace_back([&, ti]() {
+      ConcurrentBoggler<M, N> boggler(dict_);
+      CorpusWordStats& stats = partials[ti];
+      stats.hits.resize(boggler.NumWordIds());
+      stats.paths.resize(boggler.NumWordIds());
+      size_t start = boards.size() * ti / num_threads;
+      size_t end = boards.size() * (ti + 1) / num_threads;
+      for (size_t i = start; i < end; i++) {
+        stats.num_boards++;
+        if (!boggler.CountWords(boards[i].c_str(), stats.hits.data(), stats.paths.data())) {
+          stats.num_invalid++;
+        }
+      }
+    });
+  }
+  for (auto& th : threads) th.join();
+
+  CorpusWordStats out = move(partials[0]);
+  for (int ti = 1; ti < num_threads; ti++) {
+    const CorpusWordStats& stats = partials[ti];
+    out.num_boards += stats.num_boards;
+    out.num_invalid += stats.num_invalid;
+    for (size_t id = 0; id < out.hits.size(); id++) {
+      out.hits[id] += stats.hits[id];
+      out.paths[id] += stats.paths[id];
+    }
+  }
+  return out;
+}
+
+#endif  // CORPUS_STATS_H
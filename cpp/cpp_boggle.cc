@@ -6,8 +6,20 @@ namespace py = pybind11;
 using std::string;
 using std::vector;
 
+#include "alphabet_boggler.h"
+#include "alphabet_trie.h"
 #include "boggler.h"
+#include "corpus_stats.h"
+#include "iterative_boggler.h"
+#include "live_boggler.h"
+#include "multi_boggler.h"
+#include "multi_trie.h"
+#include "parallel_boggler.h"
+#include "perf_counters.h"
+#include "score_sampler.h"
 #include "trie.h"
+#include "versioned_trie.h"
+#include "word_enumerator.h"
 
 template <int M, int N>
 void declare_boggler(py::module &m, const string &pyclass_name) {
@@ -15,33 +27,312 @@ void declare_boggler(py::module &m, const string &pyclass_name) {
   py::class_<BB>(m, pyclass_name.c_str())
       .def(py::init<Trie *>())
       .def("score", &BB::Score)
+      .def(
+          "score_with_attribution",
+          [](BB &b, const char *lets) {
+            vector<int> cell_scores(M * N), cell_words(M * N);
+            int score = b.ScoreWithAttribution(lets, cell_scores.data(), cell_words.data());
+            return py::make_tuple(score, cell_scores, cell_words);
+          }
+      )
+      .def("score_pruned", &BB::ScorePruned)
+      .def(
+          "score_counting_visits",
+          [](BB &b, const char *lets, bool prune) {
+            uint64_t visits = 0;
+            int score = b.ScoreCountingVisits(lets, prune, &visits);
+            return py::make_tuple(score, visits);
+          },
+          py::arg("lets"),
+          py::arg("prune")
+      )
       .def("find_words", &BB::FindWords)
       .def("cell", &BB::Cell)
       .def("set_cell", &BB::SetCell);
 }
 
+template <int M, int N>
+void declare_iterative_boggler(py::module &m, const string &pyclass_name) {
+  using BB = IterativeBoggler<M, N>;
+  py::class_<BB>(m, pyclass_name.c_str())
+      .def(py::init<const Trie *>())
+      .def("start", &BB::Start)
+      .def("run", &BB::Run, py::arg("max_visits") = 0, py::arg("max_ms") = 0.0)
+      .def(
+          "score_with_budget",
+          [](BB &b, const char *lets, uint64_t max_visits, double max_ms) {
+            bool finished;
+            int score = b.ScoreWithBudget(lets, max_visits, max_ms, &finished);
+            return py::make_tuple(score, finished);
+          },
+          py::arg("lets"),
+          py::arg("max_visits") = 0,
+          py::arg("max_ms") = 0.0
+      )
+      .def("score", &BB::Score)
+      .def("done", &BB::Done)
+      .def("visits", &BB::Visits);
+}
+
+template <int M, int N>
+void declare_parallel_boggler(py::module &m, const string &pyclass_name) {
+  using BB = ParallelBoggler<M, N>;
+  py::class_<BB>(m, pyclass_name.c_str())
+      .def(py::init<const Trie *, int>(), py::arg("t"), py::arg("num_threads") = 0)
+      .def(
+          "find_words",
+          &BB::FindWords,
+          py::arg("lets"),
+          py::arg("multiboggle"),
+          py::call_guard<py::gil_scoped_release>()
+      )
+      .def("num_threads", &BB::NumThreads);
+}
+
+template <int M, int N>
+void declare_word_enumerator(py::module &m, const string &pyclass_name) {
+  using WE = WordEnumerator<M, N>;
+  py::class_<WE>(m, pyclass_name.c_str())
+      .def(py::init<const Trie *>())
+      .def(
+          "words",
+          [](const WE &e, const string &lets, int min_length, const vector<uint32_t> &word_ids) {
+            return e.Words(lets, min_length, {word_ids.begin(), word_ids.end()});
+          },
+          py::arg("lets"),
+          py::arg("min_length") = 0,
+          py::arg("word_ids") = vector<uint32_t>(),
+          py::keep_alive<0, 1>()  // the iterator uses the enumerator
+      );
+}
+
+template <int M, int N>
+void declare_live_boggler(py::module &m, const string &pyclass_name) {
+  using BB = LiveBoggler<M, N>;
+  py::class_<BB>(m, pyclass_name.c_str())
+      .def(py::init<VersionedTrie *>())
+      .def("score", &BB::Score, py::call_guard<py::gil_scoped_release>())
+      .def("find_words", &BB::FindWords, py::call_guard<py::gil_scoped_release>())
+      .def("version", &BB::Version);
+}
+
+template <int M, int N>
+void declare_score_sampler(py::module &m, const string &pyclass_name) {
+  using SS = ScoreSampler<M, N>;
+  py::class_<SS>(m, pyclass_name.c_str())
+      .def(py::init<const Trie *>())
+      .def(
+          "sample",
+          &SS::Sample,
+          py::arg("model"),
+          py::arg("num_boards"),
+          py::arg("seed"),
+          py::arg("num_threads") = 0,
+          py::arg("top_k") = 10,
+          py::call_guard<py::gil_scoped_release>()
+      );
+}
+
+template <int M, int N>
+void declare_corpus_analyzer(py::module &m, const string &pyclass_name) {
+  using CA = CorpusAnalyzer<M, N>;
+  py::class_<CA>(m, pyclass_name.c_str())
+      .def(py::init<const Trie *>())
+      .def(
+          "analyze",
+          &CA::Analyze,
+          py::arg("boards"),
+          py::arg("num_threads") = 0,
+          py::call_guard<py::gil_scoped_release>()
+      );
+}
+
+template <int M, int N>
+void declare_multi_boggler(py::module &m, const string &pyclass_name) {
+  using BB = MultiBoggler<M, N>;
+  py::class_<BB>(m, pyclass_name.c_str())
+      .def(py::init<MultiTrie *>())
+      .def("score", &BB::Score)
+      .def("num_dictionaries", &BB::NumDictionaries);
+}
+
+template <int K>
+void declare_alphabet_trie(py::module &m, const string &pyclass_name) {
+  using T = AlphabetTrie<K>;
+  py::class_<T>(m, pyclass_name.c_str())
+      .def_readonly_static("NOT_A_WORD", &T::kNotAWord)
+      .def("size", &T::Size)
+      .def("num_nodes", &T::NumNodes)
+      .def("bytes_used", &T::BytesUsed)
+      .def("find_word_id", &T::FindWordId)
+      .def_static("create_from_file", &T::CreateFromFile)
+      .def_static("create_from_wordlist", &T::CreateFromWordlist);
+}
+
+template <int M, int N, int K>
+void declare_alphabet_boggler(py::module &m, const string &pyclass_name) {
+  using BB = AlphabetBoggler<M, N, K>;
+  py::class_<BB>(m, pyclass_name.c_str())
+      .def(py::init<AlphabetTrie<K> *>())
+      .def("score", &BB::Score);
+}
+
+// One of a CorpusWordStats' arrays, exposed through the buffer protocol so that
+// memoryview() and numpy.asarray() can wrap it without a copy.
+struct WordIdArray {
+  const vector<uint64_t> *values;
+};
+
 PYBIND11_MODULE(cpp_boggle, m) {
   m.doc() = "C++ Boggle Scoring Tools";
 
+  py::class_<TrieStats>(m, "TrieStats")
+      .def_readonly("bytes", &TrieStats::bytes)
+      .def_readonly("num_nodes", &TrieStats::num_nodes)
+      .def_readonly("num_words", &TrieStats::num_words)
+      .def_readonly("nodes_at_depth", &TrieStats::nodes_at_depth)
+      .def_readonly("words_at_depth", &TrieStats::words_at_depth)
+      .def_readonly("child_counts_at_depth", &TrieStats::child_counts_at_depth)
+      .def("average_children", &TrieStats::AverageChildren);
+
   py::class_<Trie>(m, "Trie")
       .def(py::init())
       .def("starts_word", &Trie::StartsWord)
       .def("descend", &Trie::Descend, py::return_value_policy::reference)
       .def("is_word", &Trie::IsWord)
+      .def("word_id", &Trie::WordId)
+      .def("min_remaining", &Trie::MinRemaining)
+      .def("max_remaining", &Trie::MaxRemaining)
       .def("mark", py::overload_cast<>(&Trie::Mark))
       .def("set_mark", py::overload_cast<uintptr_t>(&Trie::Mark))
       .def("add_word", &Trie::AddWord, py::return_value_policy::reference)
       .def("find_word", &Trie::FindWord, py::return_value_policy::reference)
       .def("size", &Trie::Size)
       .def("num_nodes", &Trie::NumNodes)
+      .def("stats", &Trie::Stats)
       .def("reset_marks", &Trie::ResetMarks)
       .def("set_all_marks", &Trie::SetAllMarks)
       .def_static(
           "reverse_lookup",
           py::overload_cast<const Trie *, const Trie *>(&Trie::ReverseLookup)
       )
-      .def_static("create_from_file", &Trie::CreateFromFile)
-      .def_static("create_from_wordlist", &Trie::CreateFromWordlist);
+      .def("node_placement", &Trie::NodePlacement)
+      .def_static(
+          "create_from_file",
+          &Trie::CreateFromFile,
+          py::arg("filename"),
+          py::arg("huge_pages") = false
+      )
+      .def_static(
+          "create_from_wordlist",
+          &Trie::CreateFromWordlist,
+          py::arg("words"),
+          py::arg("huge_pages") = false
+      )
+      .def_static(
+          "create_from_file_bulk",
+          &Trie::CreateFromFileBulk,
+          py::arg("filename"),
+          py::arg("num_threads") = 0,
+          py::arg("huge_pages") = false
+      );
+
+  py::class_<MultiTrie>(m, "MultiTrie")
+      .def(py::init())
+      .def("starts_word", &MultiTrie::StartsWord)
+      .def("descend", &MultiTrie::Descend, py::return_value_policy::reference)
+      .def("is_word", &MultiTrie::IsWord)
+      .def("dictionaries", &MultiTrie::Dictionaries)
+      .def("add_word", &MultiTrie::AddWord, py::return_value_policy::reference)
+      .def("find_word", &MultiTrie::FindWord, py::return_value_policy::reference)
+      .def("size", &MultiTrie::Size)
+      .def("num_nodes", &MultiTrie::NumNodes)
+      .def("num_dictionaries", &MultiTrie::NumDictionaries)
+      .def_static("create_from_files", &MultiTrie::CreateFromFiles)
+      .def_static("create_from_wordlists", &MultiTrie::CreateFromWordlists);
+
+  py::class_<VersionedTrie>(m, "VersionedTrie")
+      .def("version", &VersionedTrie::Version)
+      .def("update", &VersionedTrie::Update, py::arg("add"), py::arg("remove"))
+      .def("size", &VersionedTrie::Size)
+      .def_static("create_from_file", &VersionedTrie::CreateFromFile)
+      .def_static("create_from_wordlist", &VersionedTrie::CreateFromWordlist);
+
+  py::class_<WordIdArray>(m, "WordIdArray", py::buffer_protocol())
+      .def_buffer([](WordIdArray &a) {
+        return py::buffer_info(
+            const_cast<uint64_t *>(a.values->data()),
+            sizeof(uint64_t),
+            py::format_descriptor<uint64_t>::format(),
+            1,
+            {py::ssize_t(a.values->size())},
+            {py::ssize_t(sizeof(uint64_t))},
+            true
+        );
+      })
+      .def("__len__", [](const WordIdArray &a) { return a.values->size(); })
+      .def("__getitem__", [](const WordIdArray &a, size_t i) {
+        if (i >= a.values->size()) throw py::index_error();
+        return (*a.values)[i];
+      });
+
+  // hits and paths are views onto the stats' arrays, which they keep alive.
+  py::class_<CorpusWordStats>(m, "CorpusWordStats")
+      .def_readonly("num_boards", &CorpusWordStats::num_boards)
+      .def_readonly("num_invalid", &CorpusWordStats::num_invalid)
+      .def_property_readonly(
+          "hits",
+          py::cpp_function(
+              [](const CorpusWordStats &s) { return WordIdArray{&s.hits}; },
+              py::keep_alive<0, 1>()
+          )
+      )
+      .def_property_readonly(
+          "paths",
+          py::cpp_function(
+              [](const CorpusWordStats &s) { return WordIdArray{&s.paths}; },
+              py::keep_alive<0, 1>()
+          )
+      );
+
+  py::class_<BoardModel>(m, "BoardModel")
+      .def_static("from_letters", &BoardModel::FromLetters)
+      .def_static("from_dice", &BoardModel::FromDice);
+
+  py::class_<SampleSummary>(m, "SampleSummary")
+      .def("num_boards", &SampleSummary::NumBoards)
+      .def("mean", &SampleSummary::Mean)
+      .def("std_dev", &SampleSummary::StdDev)
+      .def("min_score", &SampleSummary::MinScore)
+      .def("max_score", &SampleSummary::MaxScore)
+      .def("percentile", &SampleSummary::Percentile)
+      .def("count_at_least", &SampleSummary::CountAtLeast)
+      .def("histogram", &SampleSummary::Histogram)
+      .def("top_boards", &SampleSummary::TopBoards);
+
+  // Returned by WordEnumerator.words(). Yields (word_id, path) tuples.
+  // Dropping it before the end stops the search.
+  py::class_<Generator<FoundWord>>(m, "WordIterator")
+      .def("__iter__", [](py::object self) { return self; })
+      .def("__next__", [](Generator<FoundWord> &g) {
+        if (!g.Next()) throw py::stop_iteration();
+        return py::make_tuple(g.Value().word_id, g.Value().path);
+      });
+
+  py::class_<PerfCounter>(m, "PerfCounter")
+      .def_static("dtlb_load_misses", &PerfCounter::DTLBLoadMisses)
+      .def("start", &PerfCounter::Start)
+      .def("stop", &PerfCounter::Stop)
+      .def("value", &PerfCounter::Value);
+
+  py::class_<Alphabet>(m, "Alphabet")
+      .def(py::init<const string &>())
+      .def("size", &Alphabet::Size)
+      .def("letters", &Alphabet::Letters)
+      .def("code", &Alphabet::Code);
+
+  // 14 letters is enough for the JPA alphabet (see perf.py --jpa14).
+  declare_alphabet_trie<14>(m, "AlphabetTrie14");
 
   declare_boggler<2, 2>(m, "Boggler22");
   declare_boggler<2, 3>(m, "Boggler23");
@@ -50,4 +341,68 @@ PYBIND11_MODULE(cpp_boggle, m) {
   declare_boggler<4, 4>(m, "Boggler44");
   declare_boggler<4, 5>(m, "Boggler45");
   declare_boggler<5, 5>(m, "Boggler55");
+
+  declare_multi_boggler<2, 2>(m, "MultiBoggler22");
+  declare_multi_boggler<2, 3>(m, "MultiBoggler23");
+  declare_multi_boggler<3, 3>(m, "MultiBoggler33");
+  declare_multi_boggler<3, 4>(m, "MultiBoggler34");
+  declare_multi_boggler<4, 4>(m, "MultiBoggler44");
+  declare_multi_boggler<4, 5>(m, "MultiBoggler45");
+  declare_multi_boggler<5, 5>(m, "MultiBoggler55");
+
+  declare_iterative_boggler<2, 2>(m, "IterativeBoggler22");
+  declare_iterative_boggler<2, 3>(m, "IterativeBoggler23");
+  declare_iterative_boggler<3, 3>(m, "IterativeBoggler33");
+  declare_iterative_boggler<3, 4>(m, "IterativeBoggler34");
+  declare_iterative_boggler<4, 4>(m, "IterativeBoggler44");
+  declare_iterative_boggler<4, 5>(m, "IterativeBoggler45");
+  declare_iterative_boggler<5, 5>(m, "IterativeBoggler55");
+
+  declare_parallel_boggler<2, 2>(m, "ParallelBoggler22");
+  declare_parallel_boggler<2, 3>(m, "ParallelBoggler23");
+  declare_parallel_boggler<3, 3>(m, "ParallelBoggler33");
+  declare_parallel_boggler<3, 4>(m, "ParallelBoggler34");
+  declare_parallel_boggler<4, 4>(m, "ParallelBoggler44");
+  declare_parallel_boggler<4, 5>(m, "ParallelBoggler45");
+  declare_parallel_boggler<5, 5>(m, "ParallelBoggler55");
+
+  declare_word_enumerator<2, 2>(m, "WordEnumerator22");
+  declare_word_enumerator<2, 3>(m, "WordEnumerator23");
+  declare_word_enumerator<3, 3>(m, "WordEnumerator33");
+  declare_word_enumerator<3, 4>(m, "WordEnumerator34");
+  declare_word_enumerator<4, 4>(m, "WordEnumerator44");
+  declare_word_enumerator<4, 5>(m, "WordEnumerator45");
+  declare_word_enumerator<5, 5>(m, "WordEnumerator55");
+
+  declare_live_boggler<2, 2>(m, "LiveBoggler22");
+  declare_live_boggler<2, 3>(m, "LiveBoggler23");
+  declare_live_boggler<3, 3>(m, "LiveBoggler33");
+  declare_live_boggler<3, 4>(m, "LiveBoggler34");
+  declare_live_boggler<4, 4>(m, "LiveBoggler44");
+  declare_live_boggler<4, 5>(m, "LiveBoggler45");
+  declare_live_boggler<5, 5>(m, "LiveBoggler55");
+
+  declare_score_sampler<2, 2>(m, "ScoreSampler22");
+  declare_score_sampler<2, 3>(m, "ScoreSampler23");
+  declare_score_sampler<3, 3>(m, "ScoreSampler33");
+  declare_score_sampler<3, 4>(m, "ScoreSampler34");
+  declare_score_sampler<4, 4>(m, "ScoreSampler44");
+  declare_score_sampler<4, 5>(m, "ScoreSampler45");
+  declare_score_sampler<5, 5>(m, "ScoreSampler55");
+
+  declare_corpus_analyzer<2, 2>(m, "CorpusAnalyzer22");
+  declare_corpus_analyzer<2, 3>(m, "CorpusAnalyzer23");
+  declare_corpus_analyzer<3, 3>(m, "CorpusAnalyzer33");
+  declare_corpus_analyzer<3, 4>(m, "CorpusAnalyzer34");
+  declare_corpus_analyzer<4, 4>(m, "CorpusAnalyzer44");
+  declare_corpus_analyzer<4, 5>(m, "CorpusAnalyzer45");
+  declare_corpus_analyzer<5, 5>(m, "CorpusAnalyzer55");
+
+  declare_alphabet_boggler<2, 2, 14>(m, "AlphabetBoggler22_14");
+  declare_alphabet_boggler<2, 3, 14>(m, "AlphabetBoggler23_14");
+  declare_alphabet_boggler<3, 3, 14>(m, "AlphabetBoggler33_14");
+  declare_alphabet_boggler<3, 4, 14>(m, "AlphabetBoggler34_14");
+  declare_alphabet_boggler<4, 4, 14>(m, "AlphabetBoggler44_14");
+  declare_alphabet_boggler<4, 5, 14>(m, "AlphabetBoggler45_14");
+  declare_alphabet_boggler<5, 5, 14>(m, "AlphabetBoggler55_14");
 }
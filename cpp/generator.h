@@ -0,0 +1,93 @@
+// A minimal lazy generator for C++20 coroutines, until std::generator (C++23)
+// is available in all the compilers we use.
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+// A coroutine that returns Generator<T> runs until its first co_yield when
+// Next() is first called, and on to the next co_yield with each call after
+// that. Destroying the Generator destroys the suspended coroutine, so a
+// computation that nobody reads the rest of doesn't keep running.
+//
+//   Generator<int> Count(int n) {
+//     for (int i = 0; i < n; i++) co_yield i;
+//   }
+//
+//   for (int i : Count(10)) { ... }
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    std::optional<T> value;
+
+    Generator get_return_object() {
+      return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(T v) {
+      value = std::move(v);
+      return {};
+    }
+    void return_void() {}
+    // This repo doesn't use exceptions.
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Generator(Generator&& other) noexcept : h_(std::exchange(other.h_, nullptr)) {}
+  Generator& operator=(Generator&& other) noexcept {
+    if (this != &other) {
+      if (h_) h_.destroy();
+      h_ = std::exchange(other.h_, nullptr);
+    }
+    return *this;
+  }
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+  ~Generator() {
+    if (h_) h_.destroy();
+  }
+
+  // Runs the coroutine to its next co_yield. Returns false once it's finished.
+  bool Next() {
+    if (!h_ || h_.done()) return false;
+    h_.promise().value.reset();
+    h_.resume();
+    return !h_.done();
+  }
+
+  // The value from the last co_yield. Only valid after Next() returns true.
+  T& Value() { return *h_.promise().value; }
+
+  class iterator {
+   public:
+    explicit iterator(Generator* g) : g_(g) {}
+    T& operator*() const { return g_->Value(); }
+    iterator& operator++() {
+      if (!g_->Next()) g_ = nullptr;
+      return *this;
+    }
+    bool operator==(std::default_sentinel_t) const { return g_ == nullptr; }
+
+   private:
+    Generator* g_;
+  };
+
+  iterator begin() {
+    iterator it(this);
+    return ++it;
+  }
+  std::default_sentinel_t end() { return {}; }
+
+ private:
+  explicit Generator(std::coroutine_handle<promise_type> h) : h_(h) {}
+
+  std::coroutine_handle<promise_type> h_;
+};
+
+#endif  // GENERATOR_H
@@ -0,0 +1,184 @@
+// Solver for MxN Boggle whose work per call can be bounded.
+#ifndef ITERATIVE_BOGGLER_H
+#define ITERATIVE_BOGGLER_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <vector>
+
+#include "boggler.h"
+#include "constants.h"
+#include "neighbors.h"
+#include "trie.h"
+
+// Boggler's recursive DFS has to run to completion, and some boards (e.g. ones
+// full of e, s and r) take orders of magnitude longer than typical ones. This
+// runs the same search with an explicit stack instead, so it can stop after a
+// budget of trie node visits or time and pick up later where it left off.
+//
+// Like ConcurrentBoggler, this keeps its marks in a table indexed by word id
+// rather than in the Trie, so other Bogglers can use the Trie in between calls
+// (or at the same time, from other threads) without disturbing a paused search.
+//
+//   IterativeBoggler<4, 4> b(trie);
+//   b.Start(board);
+//   while (!b.Run(100000, 0)) { /* do something else */ }
+//   b.Score();
+template <int M, int N>
+class IterativeBoggler {
+ public:
+  IterativeBoggler(const Trie* t)
+      : dict_(t), runs_(0), score_(0), visits_(0), done_(true) {
+    static_assert(M * N <= MAX_STACK_DEPTH, "Board is too large for the stack");
+    marks_.resize(t->MaxWordId() + 1, 0);
+  }
+
+  // Sets up a search of a new board. Returns false for an invalid board.
+  bool Start(const char* lets);
+
+  // Continues the search until it finishes or runs out of budget: at most
+  // max_visits more trie node visits and max_ms more milliseconds (0 means no
+  // limit). Returns true if the search has finished.
+  bool Run(uint64_t max_visits, double max_ms);
+
+  // Start() and Run() in one. Returns the exact score if the search finished
+  // within the budget, or -1 for an invalid board. Otherwise, *finished is set
+  // to false, this returns the partial score and Run() can resume the search.
+  int ScoreWithBudget(
+      const char* lets, uint64_t max_visits, double max_ms, bool* finished
+  );
+
+  // The exact score once Done(), otherwise the score of the words found so far.
+  unsigned int Score() const { return score_; }
+  bool Done() const { return done_; }
+  // Trie node visits since Start().
+  uint64_t Visits() const { return visits_; }
+
+  unsigned int NumCells() { return M * N; }
+
+ private:
+  struct Frame {
+    const Trie* t;
+    uint8_t cell;
+    uint8_t len;   // with "Qu" counting as two letters
+    uint8_t next;  // index into Neighbors<M, N>::NEIGHBORS[cell] to try next
+  };
+
+  void Push(unsigned int i, unsigned int len, const Trie* t);
+
+  const Trie* dict_;
+  vector<uint32_t> marks_;  // marks_[word_id] == runs_ if found on this board
+  uint32_t runs_;
+  int bd_[M * N];
+  unsigned int used_;
+  unsigned int score_;
+  uint64_t visits_;
+  bool done_;
+  int next_start_;  // next cell to start a path from when the stack is empty
+  int depth_;
+  // A path uses each cell at most once, so it never has more than M * N frames.
+  Frame stack_[MAX_STACK_DEPTH];
+};
+
+template <int M, int N>
+bool IterativeBoggler<M, N>::Start(const char* lets) {
+  done_ = true;
+  if (!ParseBoardString(lets, bd_, M * N)) return false;
+  if (++runs_ == 0) {
+    fill(marks_.begin(), marks_.end(), 0);
+    runs_ = 1;
+  }
+  used_ = 0;
+  score_ = 0;
+  visits_ = 0;
+  next_start_ = 0;
+  depth_ = 0;
+  done_ = false;
+  return true;
+}
+
+template <int M, int N>
+void IterativeBoggler<M, N>::Push(unsigned int i, unsigned int len, const Trie* t) {
+  visits_++;
+  used_ ^= (1 << i);
+  len += (bd_[i] == kQ ? 2 : 1);
+  if (t->IsWord()) {
+    uint32_t& mark = marks_[t->WordId()];
+    if (mark != runs_) {
+      mark = runs_;
+      score_ += kWordScores[len];
+    }
+  }
+  stack_[depth_++] = {t, uint8_t(i), uint8_t(len), 1};
+}
+
+template <int M, int N>
+bool IterativeBoggler<M, N>::Run(uint64_t max_visits, double max_ms) {
+  if (done_) return true;
+  uint64_t max_total_visits = max_visits ? visits_ + max_visits : UINT64_MAX;
+  auto deadline = chrono::steady_clock::now() +
+                  chrono::duration_cast<chrono::steady_clock::duration>(
+                      chrono::duration<double, milli>(max_ms)
+                  );
+
+  while (true) {
+    unsigned int i, len;
+    const Trie* t;
+    if (depth_ == 0) {
+      if (next_start_ == M * N) {
+        done_ = true;
+        return true;
+      }
+      i = next_start_;
+      int c = bd_[i];
+      if (c == -1 || !dict_->StartsWord(c)) {
+        next_start_++;
+        continue;
+      }
+      len = 0;
+      t = dict_->Descend(c);
+    } else {
+      Frame& f = stack_[depth_ - 1];
+      const auto& neighbors = Neighbors<M, N>::NEIGHBORS[f.cell];
+      if (f.next > neighbors[0]) {
+        used_ ^= (1 << f.cell);
+        depth_--;
+        if (depth_ == 0) next_start_++;
+        continue;
+      }
+      i = neighbors[f.next];
+      int cc = bd_[i];
+      if ((used_ & (1 << i)) || cc == -1 || !f.t->StartsWord(cc)) {
+        f.next++;
+        continue;
+      }
+      len = f.len;
+      t = f.t->Descend(cc);
+    }
+
+    // Check the budget before each visit. Reading the clock is relatively
+    // slow, so only do it every so often.
+    if (visits_ >= max_total_visits) return false;
+    if (max_ms > 0 && (visits_ & 1023) == 0 &&
+        chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    if (depth_ > 0) stack_[depth_ - 1].next++;
+    Push(i, len, t);
+  }
+}
+
+template <int M, int N>
+int IterativeBoggler<M, N>::ScoreWithBudget(
+    const char* lets, uint64_t max_visits, double max_ms, bool* finished
+) {
+  if (!Start(lets)) {
+    *finished = true;
+    return -1;
+  }
+  *finished = Run(max_visits, max_ms);
+  return score_;
+}
+
+#endif  // ITERATIVE_BOGGLER_H
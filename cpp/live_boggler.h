@@ -0,0 +1,48 @@
+// Solver for MxN Boggle against a VersionedTrie.
+#ifndef LIVE_BOGGLER_H
+#define LIVE_BOGGLER_H
+
+#include "concurrent_boggler.h"
+#include "versioned_trie.h"
+
+// Wraps a ConcurrentBoggler and moves it to the latest snapshot of the
+// dictionary before each board. A board is always scored against a single
+// version, and checking for a new version is just an atomic load. Each
+// LiveBoggler keeps its own marks, so any number of them can share a
+// VersionedTrie, one per thread.
+template <int M, int N>
+class LiveBoggler {
+ public:
+  LiveBoggler(VersionedTrie* dict)
+      : dict_(dict),
+        version_(0),
+        snapshot_(dict->Snapshot(&version_)),
+        boggler_(snapshot_.get()) {}
+
+  int Score(const char* lets) {
+    Refresh();
+    return boggler_.Score(lets);
+  }
+
+  vector<vector<int>> FindWords(const string& lets, bool multiboggle) {
+    Refresh();
+    return boggler_.FindWords(lets, multiboggle);
+  }
+
+  // The version of the dictionary used for the most recent board.
+  uint64_t Version() const { return version_; }
+
+ private:
+  void Refresh() {
+    if (dict_->Version() == version_) return;
+    snapshot_ = dict_->Snapshot(&version_);
+    boggler_.SetTrie(snapshot_.get());
+  }
+
+  VersionedTrie* dict_;
+  uint64_t version_;
+  shared_ptr<Trie> snapshot_;
+  ConcurrentBoggler<M, N> boggler_;
+};
+
+#endif  // LIVE_BOGGLER_H
@@ -0,0 +1,82 @@
+// Solver for MxN Boggle that scores against several dictionaries in one pass.
+#ifndef MULTI_BOGGLER_H
+#define MULTI_BOGGLER_H
+
+#include "boggler.h"
+#include "constants.h"
+#include "multi_trie.h"
+#include "neighbors.h"
+
+template <int M, int N>
+class MultiBoggler {
+ public:
+  MultiBoggler(MultiTrie* t)
+      : dict_(t), num_dicts_(t->NumDictionaries()), runs_(0) {}
+
+  // Returns one score per dictionary, or all -1 if the board is invalid.
+  vector<int> Score(const char* lets);
+
+  unsigned int NumCells() { return M * N; }
+  int NumDictionaries() const { return num_dicts_; }
+
+ private:
+  void DoDFS(unsigned int i, unsigned int len, MultiTrie* t);
+  void InternalScore();
+
+  MultiTrie* dict_;
+  int num_dicts_;
+  unsigned int used_;
+  int bd_[M * N];
+  unsigned int scores_[MultiTrie::kMaxDictionaries];
+  unsigned int runs_;
+};
+
+template <int M, int N>
+vector<int> MultiBoggler<M, N>::Score(const char* lets) {
+  if (!ParseBoardString(lets, bd_, M * N)) {
+    return vector<int>(num_dicts_, -1);
+  }
+  InternalScore();
+  return vector<int>(scores_, scores_ + num_dicts_);
+}
+
+// A word node is visited at most once per board no matter which dictionaries
+// contain it, so a single mark per node dedupes for all of them.
+template <int M, int N>
+void MultiBoggler<M, N>::InternalScore() {
+  runs_ = dict_->Mark() + 1;
+  dict_->Mark(runs_);
+  used_ = 0;
+  for (int d = 0; d < num_dicts_; d++) scores_[d] = 0;
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (dict_->StartsWord(c)) DoDFS(i, 0, dict_->Descend(c));
+  }
+}
+
+template <int M, int N>
+void MultiBoggler<M, N>::DoDFS(unsigned int i, unsigned int len, MultiTrie* t) {
+  int c = bd_[i];
+  used_ ^= (1 << i);
+  len += (c == kQ ? 2 : 1);
+  if (t->IsWord() && t->Mark() != runs_) {
+    t->Mark(runs_);
+    unsigned int score = kWordScores[len];
+    for (uint32_t dicts = t->Dictionaries(); dicts; dicts &= dicts - 1) {
+      scores_[__builtin_ctz(dicts)] += score;
+    }
+  }
+
+  UnrolledNeighbors<M, N>::ForEach(i, [&](unsigned int idx) {
+    if ((used_ & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (t->StartsWord(cc)) {
+        DoDFS(idx, len, t->Descend(cc));
+      }
+    }
+  });
+
+  used_ ^= (1 << i);
+}
+
+#endif  // MULTI_BOGGLER_H
@@ -0,0 +1,131 @@
+#include "multi_trie.h"
+
+#include <stdio.h>
+
+#include <cassert>
+
+using namespace std;
+
+static inline int idx(char x) { return x - 'a'; }
+
+MultiTrie::MultiTrie() {
+  for (int i = 0; i < kNumLetters; i++) children_[i] = NULL;
+  mark_ = 0;
+  dicts_ = 0;
+  num_dicts_ = 0;
+}
+
+MultiTrie::~MultiTrie() {
+  for (int i = 0; i < kNumLetters; i++) {
+    if (children_[i]) delete children_[i];
+  }
+}
+
+MultiTrie* MultiTrie::AddWord(const char* wd, int dict) {
+  assert(dict >= 0 && dict < kMaxDictionaries);
+  if (!wd) return NULL;
+  if (dict >= num_dicts_) num_dicts_ = dict + 1;
+  MultiTrie* t = this;
+  for (; *wd; wd++) {
+    int c = idx(*wd);
+    if (!t->StartsWord(c)) t->children_[c] = new MultiTrie;
+    t = t->Descend(c);
+  }
+  t->AddDictionary(dict);
+  return t;
+}
+
+size_t MultiTrie::Size() {
+  size_t size = 0;
+  if (IsWord()) size++;
+  for (int i = 0; i < kNumLetters; i++) {
+    if (StartsWord(i)) size += Descend(i)->Size();
+  }
+  return size;
+}
+
+size_t MultiTrie::NumNodes() {
+  size_t count = 1;
+  for (int i = 0; i < kNumLetters; i++) {
+    if (StartsWord(i)) count += Descend(i)->NumNodes();
+  }
+  return count;
+}
+
+uint32_t MultiTrie::AllDictionaries() {
+  uint32_t dicts = dicts_;
+  for (int i = 0; i < kNumLetters; i++) {
+    if (StartsWord(i)) dicts |= Descend(i)->AllDictionaries();
+  }
+  return dicts;
+}
+
+MultiTrie* MultiTrie::FindWord(const char* wd) {
+  if (!wd) return NULL;
+  if (!*wd) return IsWord() ? this : NULL;
+  int c = idx(*wd);
+  if (!StartsWord(c)) return NULL;
+  return Descend(c)->FindWord(wd + 1);
+}
+
+/* static */ unique_ptr<MultiTrie> MultiTrie::CreateFromFiles(
+    const vector<string>& filenames
+) {
+  if (filenames.size() > kMaxDictionaries) {
+    fprintf(
+        stderr, "At most %d dictionaries are supported\n", kMaxDictionaries
+    );
+    return NULL;
+  }
+
+  char line[80];
+  unique_ptr<MultiTrie> t(new MultiTrie);
+  t->num_dicts_ = filenames.size();
+  for (size_t d = 0; d < filenames.size(); d++) {
+    const char* filename = filenames[d].c_str();
+    FILE* f = fopen(filename, "r");
+    if (!f) {
+      fprintf(stderr, "Couldn't open %s\n", filename);
+      return NULL;
+    }
+    int count = 0;
+    while (fscanf(f, "%s", line) == 1) {
+      if (Trie::BogglifyWord(line)) {
+        t->AddWord(line, d);
+        count++;
+      }
+    }
+    fclose(f);
+    fprintf(stderr, "Loaded %d words from %s (dictionary %zu)\n", count, filename, d);
+  }
+
+  size_t num_nodes = t->NumNodes();
+  fprintf(
+      stderr,
+      "MultiTrie has %zu words and %zu nodes using %zu bytes\n",
+      t->Size(),
+      num_nodes,
+      num_nodes * sizeof(MultiTrie)
+  );
+  return t;
+}
+
+/* static */ unique_ptr<MultiTrie> MultiTrie::CreateFromWordlists(
+    const vector<vector<string>>& wordlists
+) {
+  if (wordlists.size() > kMaxDictionaries) {
+    fprintf(
+        stderr, "At most %d dictionaries are supported\n", kMaxDictionaries
+    );
+    return NULL;
+  }
+
+  unique_ptr<MultiTrie> t(new MultiTrie);
+  t->num_dicts_ = wordlists.size();
+  for (size_t d = 0; d < wordlists.size(); d++) {
+    for (const auto& word : wordlists[d]) {
+      t->AddWord(word.c_str(), d);
+    }
+  }
+  return t;
+}
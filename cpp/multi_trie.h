@@ -0,0 +1,65 @@
+#ifndef MULTI_TRIE_H__
+#define MULTI_TRIE_H__
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trie.h"
+
+using namespace std;
+
+// A Trie over the union of several dictionaries. Each word node carries a
+// bitmask of the dictionaries that contain it, so one traversal of a board
+// can score it against all of them at once.
+class MultiTrie {
+ public:
+  static const int kMaxDictionaries = 32;
+
+  MultiTrie();
+  ~MultiTrie();
+
+  // Fast operations
+  bool StartsWord(int i) const { return children_[i]; }
+  MultiTrie* Descend(int i) const { return children_[i]; }
+
+  bool IsWord() const { return dicts_; }
+  // Bit d is set if dictionary d contains this word.
+  uint32_t Dictionaries() const { return dicts_; }
+  void AddDictionary(int dict) { dicts_ |= (1u << dict); }
+
+  void Mark(uintptr_t m) { mark_ = m; }
+  uintptr_t Mark() { return mark_; }
+
+  // Number of dictionaries this MultiTrie was built from, including empty
+  // ones. Only the root keeps track of this.
+  int NumDictionaries() const { return num_dicts_; }
+
+  // Trie construction
+  // Call this on the root. Returns a pointer to the new MultiTrie node at the
+  // end of the word.
+  MultiTrie* AddWord(const char* wd, int dict);
+  // Dictionary i in the list gets bit i.
+  static unique_ptr<MultiTrie> CreateFromFiles(const vector<string>& filenames);
+  static unique_ptr<MultiTrie> CreateFromWordlists(
+      const vector<vector<string>>& wordlists
+  );
+
+  // Some slower methods that operate on the entire MultiTrie (not just a node).
+  size_t Size();
+  size_t NumNodes();
+  // Union of Dictionaries() over all words.
+  uint32_t AllDictionaries();
+  MultiTrie* FindWord(const char* wd);
+
+ private:
+  MultiTrie* children_[kNumLetters];
+  uintptr_t mark_;
+  uint32_t dicts_;
+  int num_dicts_;  // Root only; fits in padding.
+};
+
+#endif
@@ -198,4 +198,196 @@ const int (&Neighbors<4, 4>::NEIGHBORS)[4 * 4][9] = NEIGHBORS_4x4;
 const int (&Neighbors<4, 5>::NEIGHBORS)[4 * 5][9] = NEIGHBORS_4x5;
 const int (&Neighbors<5, 5>::NEIGHBORS)[5 * 5][9] = NEIGHBORS_5x5;
 
+// Calls f(j) for each neighbor j of cell i. This is force-inlined and unrolls
+// into the same kind of switch statement as Boggler::DoDFS, so it's as fast as
+// the REC macros in hot loops (without always_inline it's ~30% slower).
+template <int M, int N>
+struct UnrolledNeighbors;
+
+// clang-format off
+
+/*[[[cog
+from boggle.neighbors import NEIGHBORS
+
+for (w, h), neighbors in NEIGHBORS.items():
+    print(f"""
+// {w}x{h}
+template <>
+struct UnrolledNeighbors<{w}, {h}> {{
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {{
+    switch (i) {{""")
+    for i, ns in enumerate(neighbors):
+        calls = " ".join(f"f({n});" for n in ns)
+        print(f"      case {i}: {calls} break;")
+    print("""    }
+  }
+};""")
+]]]*/
+
+// 2x2
+template <>
+struct UnrolledNeighbors<2, 2> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(2); f(3); break;
+      case 1: f(0); f(2); f(3); break;
+      case 2: f(0); f(1); f(3); break;
+      case 3: f(0); f(1); f(2); break;
+    }
+  }
+};
+
+// 2x3
+template <>
+struct UnrolledNeighbors<2, 3> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(3); f(4); break;
+      case 1: f(0); f(2); f(3); f(4); f(5); break;
+      case 2: f(1); f(4); f(5); break;
+      case 3: f(0); f(1); f(4); break;
+      case 4: f(0); f(1); f(2); f(3); f(5); break;
+      case 5: f(1); f(2); f(4); break;
+    }
+  }
+};
+
+// 3x3
+template <>
+struct UnrolledNeighbors<3, 3> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(3); f(4); break;
+      case 1: f(0); f(2); f(3); f(4); f(5); break;
+      case 2: f(1); f(4); f(5); break;
+      case 3: f(0); f(1); f(4); f(6); f(7); break;
+      case 4: f(0); f(1); f(2); f(3); f(5); f(6); f(7); f(8); break;
+      case 5: f(1); f(2); f(4); f(7); f(8); break;
+      case 6: f(3); f(4); f(7); break;
+      case 7: f(3); f(4); f(5); f(6); f(8); break;
+      case 8: f(4); f(5); f(7); break;
+    }
+  }
+};
+
+// 3x4
+template <>
+struct UnrolledNeighbors<3, 4> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(4); f(5); break;
+      case 1: f(0); f(2); f(4); f(5); f(6); break;
+      case 2: f(1); f(3); f(5); f(6); f(7); break;
+      case 3: f(2); f(6); f(7); break;
+      case 4: f(0); f(1); f(5); f(8); f(9); break;
+      case 5: f(0); f(1); f(2); f(4); f(6); f(8); f(9); f(10); break;
+      case 6: f(1); f(2); f(3); f(5); f(7); f(9); f(10); f(11); break;
+      case 7: f(2); f(3); f(6); f(10); f(11); break;
+      case 8: f(4); f(5); f(9); break;
+      case 9: f(4); f(5); f(6); f(8); f(10); break;
+      case 10: f(5); f(6); f(7); f(9); f(11); break;
+      case 11: f(6); f(7); f(10); break;
+    }
+  }
+};
+
+// 4x4
+template <>
+struct UnrolledNeighbors<4, 4> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(4); f(5); break;
+      case 1: f(0); f(2); f(4); f(5); f(6); break;
+      case 2: f(1); f(3); f(5); f(6); f(7); break;
+      case 3: f(2); f(6); f(7); break;
+      case 4: f(0); f(1); f(5); f(8); f(9); break;
+      case 5: f(0); f(1); f(2); f(4); f(6); f(8); f(9); f(10); break;
+      case 6: f(1); f(2); f(3); f(5); f(7); f(9); f(10); f(11); break;
+      case 7: f(2); f(3); f(6); f(10); f(11); break;
+      case 8: f(4); f(5); f(9); f(12); f(13); break;
+      case 9: f(4); f(5); f(6); f(8); f(10); f(12); f(13); f(14); break;
+      case 10: f(5); f(6); f(7); f(9); f(11); f(13); f(14); f(15); break;
+      case 11: f(6); f(7); f(10); f(14); f(15); break;
+      case 12: f(8); f(9); f(13); break;
+      case 13: f(8); f(9); f(10); f(12); f(14); break;
+      case 14: f(9); f(10); f(11); f(13); f(15); break;
+      case 15: f(10); f(11); f(14); break;
+    }
+  }
+};
+
+// 4x5
+template <>
+struct UnrolledNeighbors<4, 5> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(5); f(6); break;
+      case 1: f(0); f(2); f(5); f(6); f(7); break;
+      case 2: f(1); f(3); f(6); f(7); f(8); break;
+      case 3: f(2); f(4); f(7); f(8); f(9); break;
+      case 4: f(3); f(8); f(9); break;
+      case 5: f(0); f(1); f(6); f(10); f(11); break;
+      case 6: f(0); f(1); f(2); f(5); f(7); f(10); f(11); f(12); break;
+      case 7: f(1); f(2); f(3); f(6); f(8); f(11); f(12); f(13); break;
+      case 8: f(2); f(3); f(4); f(7); f(9); f(12); f(13); f(14); break;
+      case 9: f(3); f(4); f(8); f(13); f(14); break;
+      case 10: f(5); f(6); f(11); f(15); f(16); break;
+      case 11: f(5); f(6); f(7); f(10); f(12); f(15); f(16); f(17); break;
+      case 12: f(6); f(7); f(8); f(11); f(13); f(16); f(17); f(18); break;
+      case 13: f(7); f(8); f(9); f(12); f(14); f(17); f(18); f(19); break;
+      case 14: f(8); f(9); f(13); f(18); f(19); break;
+      case 15: f(10); f(11); f(16); break;
+      case 16: f(10); f(11); f(12); f(15); f(17); break;
+      case 17: f(11); f(12); f(13); f(16); f(18); break;
+      case 18: f(12); f(13); f(14); f(17); f(19); break;
+      case 19: f(13); f(14); f(18); break;
+    }
+  }
+};
+
+// 5x5
+template <>
+struct UnrolledNeighbors<5, 5> {
+  template <typename F>
+  __attribute__((always_inline)) static inline void ForEach(unsigned int i, F&& f) {
+    switch (i) {
+      case 0: f(1); f(5); f(6); break;
+      case 1: f(0); f(2); f(5); f(6); f(7); break;
+      case 2: f(1); f(3); f(6); f(7); f(8); break;
+      case 3: f(2); f(4); f(7); f(8); f(9); break;
+      case 4: f(3); f(8); f(9); break;
+      case 5: f(0); f(1); f(6); f(10); f(11); break;
+      case 6: f(0); f(1); f(2); f(5); f(7); f(10); f(11); f(12); break;
+      case 7: f(1); f(2); f(3); f(6); f(8); f(11); f(12); f(13); break;
+      case 8: f(2); f(3); f(4); f(7); f(9); f(12); f(13); f(14); break;
+      case 9: f(3); f(4); f(8); f(13); f(14); break;
+      case 10: f(5); f(6); f(11); f(15); f(16); break;
+      case 11: f(5); f(6); f(7); f(10); f(12); f(15); f(16); f(17); break;
+      case 12: f(6); f(7); f(8); f(11); f(13); f(16); f(17); f(18); break;
+      case 13: f(7); f(8); f(9); f(12); f(14); f(17); f(18); f(19); break;
+      case 14: f(8); f(9); f(13); f(18); f(19); break;
+      case 15: f(10); f(11); f(16); f(20); f(21); break;
+      case 16: f(10); f(11); f(12); f(15); f(17); f(20); f(21); f(22); break;
+      case 17: f(11); f(12); f(13); f(16); f(18); f(21); f(22); f(23); break;
+      case 18: f(12); f(13); f(14); f(17); f(19); f(22); f(23); f(24); break;
+      case 19: f(13); f(14); f(18); f(23); f(24); break;
+      case 20: f(15); f(16); f(21); break;
+      case 21: f(15); f(16); f(17); f(20); f(22); break;
+      case 22: f(16); f(17); f(18); f(21); f(23); break;
+      case 23: f(17); f(18); f(19); f(22); f(24); break;
+      case 24: f(18); f(19); f(23); break;
+    }
+  }
+};
+// [[[end]]]
+
+// clang-format on
+
 #endif  // NEIGHBORS_H
@@ -0,0 +1,281 @@
+// Finds the words on a single MxN board using several threads.
+#ifndef PARALLEL_BOGGLER_H
+#define PARALLEL_BOGGLER_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "boggler.h"
+#include "constants.h"
+#include "neighbors.h"
+#include "trie.h"
+
+using namespace std;
+
+// Boggler::FindWords runs on one core, so on a big board its latency is that
+// of the whole search. This splits the search into tasks, one for each pair of
+// a starting cell and the neighbor it goes to next, and runs them on a pool of
+// threads.
+//
+// A word can be found by several tasks. Each word's entry in first_task_ holds
+// the lowest-numbered task that has found it so far, and tasks only record a
+// word if they lower it. At the end, the per-task results are merged in task
+// order, keeping each word from the task that ended up lowest. Tasks are
+// numbered in the order Boggler's DFS would run them, so the output is the same
+// as Boggler::FindWords, in the same order, however many threads there are.
+//
+// This doesn't write to the Trie, so it can share one with other Bogglers.
+// Overlapping calls to FindWords take turns, since they share the pool.
+template <int M, int N>
+class ParallelBoggler {
+ public:
+  // num_threads=0 means one per core. The thread calling FindWords is one of
+  // them.
+  ParallelBoggler(const Trie* t, int num_threads);
+  ~ParallelBoggler();
+
+  // Same as Boggler::FindWords.
+  vector<vector<int>> FindWords(const string& lets, bool multiboggle);
+
+  int NumThreads() const { return searchers_.size(); }
+  unsigned int NumCells() { return M * N; }
+
+ private:
+  // Every path that starts at cell and then goes to next. If next is -1, just
+  // the one-cell path.
+  struct Task {
+    int cell;
+    int next;
+  };
+
+  struct Found {
+    uint32_t word_id;
+    uint32_t used;  // only needed for multiboggle
+    vector<int> path;
+  };
+
+  // DFS state for one thread.
+  struct Searcher {
+    int task;
+    unsigned int used;
+    vector<int> seq;
+    unordered_set<uint64_t> found_paths;  // for multiboggle, per task
+  };
+
+  static const uint16_t kNoTask = UINT16_MAX;
+  static_assert(M * N * 9 < kNoTask, "Too many tasks for first_task_");
+
+  void WorkerLoop(int index);
+  void RunTasks(Searcher& s);
+  void RunTask(Searcher& s, int task);
+  void DFS(Searcher& s, unsigned int i, const Trie* t);
+  void Record(Searcher& s, const Trie* t);
+
+  const Trie* dict_;
+  int bd_[M * N];
+  bool multiboggle_;
+  vector<Task> tasks_;
+  vector<vector<Found>> found_;  // by task
+  atomic<int> next_task_;
+  vector<atomic<uint16_t>> first_task_;  // by word id; kNoTask between boards
+  vector<Searcher> searchers_;           // searchers_[0] is the calling thread's
+
+  // Held for the whole of each FindWords call. Everything above is per-board.
+  mutex call_mutex_;
+
+  // Thread pool. Each FindWords call bumps generation_ to wake the workers.
+  mutex mutex_;
+  condition_variable work_cv_;
+  condition_variable done_cv_;
+  uint64_t generation_;
+  int num_busy_;
+  bool stopping_;
+  vector<thread> workers_;
+};
+
+template <int M, int N>
+ParallelBoggler<M, N>::ParallelBoggler(const Trie* t, int num_threads)
+    : dict_(t),
+      first_task_(t->MaxWordId() + 1),
+      generation_(0),
+      num_busy_(0),
+      stopping_(false) {
+  for (auto& f : first_task_) f.store(kNoTask, memory_order_relaxed);
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+  searchers_.resize(num_threads);
+  for (int i = 1; i < num_threads; i++) {
+    workers_.emplace_back(&ParallelBoggler::WorkerLoop, this, i);
+  }
+}
+
+template <int M, int N>
+ParallelBoggler<M, N>::~ParallelBoggler() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& w : workers_) w.join();
+}
+
+template <int M, int N>
+void ParallelBoggler<M, N>::WorkerLoop(int index) {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      unique_lock<mutex> lock(mutex_);
+      work_cv_.wait(lock, [&]() { return stopping_ || generation_ != generation; });
+      if (stopping_) return;
+      generation = generation_;
+    }
+    RunTasks(searchers_[index]);
+    {
+      lock_guard<mutex> lock(mutex_);
+      if (--num_busy_ == 0) done_cv_.notify_one();
+    }
+  }
+}
+
+template <int M, int N>
+vector<vector<int>> ParallelBoggler<M, N>::FindWords(
+    const string& lets, bool multiboggle
+) {
+  lock_guard<mutex> call_lock(call_mutex_);
+  vector<vector<int>> out;
+  if (!ParseBoardString(lets.c_str(), bd_, M * N)) {
+    out.push_back({-1});
+    return out;
+  }
+  multiboggle_ = multiboggle;
+
+  tasks_.clear();
+  for (int i = 0; i < M * N; i++) {
+    int c = bd_[i];
+    if (c == -1 || !dict_->StartsWord(c)) continue;
+    tasks_.push_back({i, -1});
+    const Trie* t = dict_->Descend(c);
+    auto& neighbors = Neighbors<M, N>::NEIGHBORS[i];
+    for (int j = 1; j <= neighbors[0]; j++) {
+      int cc = bd_[neighbors[j]];
+      if (cc != -1 && t->StartsWord(cc)) tasks_.push_back({i, neighbors[j]});
+    }
+  }
+  found_.resize(max(found_.size(), tasks_.size()));
+  for (size_t k = 0; k < tasks_.size(); k++) found_[k].clear();
+  next_task_.store(0, memory_order_relaxed);
+
+  {
+    lock_guard<mutex> lock(mutex_);
+    generation_++;
+    num_busy_ = workers_.size();
+  }
+  work_cv_.notify_all();
+  RunTasks(searchers_[0]);
+  {
+    unique_lock<mutex> lock(mutex_);
+    done_cv_.wait(lock, [&]() { return num_busy_ == 0; });
+  }
+
+  if (multiboggle) {
+    unordered_set<uint64_t> seen;
+    for (size_t k = 0; k < tasks_.size(); k++) {
+      for (auto& f : found_[k]) {
+        if (seen.emplace((uint64_t(f.word_id) << 32) + f.used).second) {
+          out.push_back(move(f.path));
+        }
+      }
+    }
+  } else {
+    for (size_t k = 0; k < tasks_.size(); k++) {
+      for (auto& f : found_[k]) {
+        if (first_task_[f.word_id].load(memory_order_relaxed) == k) {
+          out.push_back(move(f.path));
+        }
+      }
+    }
+    // Every word that was found has an entry, so this resets all of them.
+    for (size_t k = 0; k < tasks_.size(); k++) {
+      for (const auto& f : found_[k]) {
+        first_task_[f.word_id].store(kNoTask, memory_order_relaxed);
+      }
+    }
+  }
+  return out;
+}
+
+template <int M, int N>
+void ParallelBoggler<M, N>::RunTasks(Searcher& s) {
+  int num_tasks = tasks_.size();
+  while (true) {
+    // Tasks are handed out in order, so the lowest-numbered task that finds a
+    // word usually gets to it first and the others don't record it at all.
+    int task = next_task_.fetch_add(1, memory_order_relaxed);
+    if (task >= num_tasks) return;
+    RunTask(s, task);
+  }
+}
+
+template <int M, int N>
+void ParallelBoggler<M, N>::RunTask(Searcher& s, int task) {
+  const Task& tk = tasks_[task];
+  s.task = task;
+  s.found_paths.clear();
+  s.seq.assign(1, tk.cell);
+  s.used = 1 << tk.cell;
+  const Trie* t = dict_->Descend(bd_[tk.cell]);
+  if (tk.next == -1) {
+    if (t->IsWord()) Record(s, t);
+  } else {
+    DFS(s, tk.next, t->Descend(bd_[tk.next]));
+  }
+}
+
+template <int M, int N>
+void ParallelBoggler<M, N>::DFS(Searcher& s, unsigned int i, const Trie* t) {
+  s.used ^= (1 << i);
+  s.seq.push_back(i);
+  if (t->IsWord()) Record(s, t);
+
+  auto& neighbors = Neighbors<M, N>::NEIGHBORS[i];
+  auto n_neighbors = neighbors[0];
+  for (int j = 1; j <= n_neighbors; j++) {
+    auto idx = neighbors[j];
+    if ((s.used & (1 << idx)) == 0) {
+      int cc = bd_[idx];
+      if (cc != -1 && t->StartsWord(cc)) {
+        DFS(s, idx, t->Descend(cc));
+      }
+    }
+  }
+
+  s.used ^= (1 << i);
+  s.seq.pop_back();
+}
+
+template <int M, int N>
+void ParallelBoggler<M, N>::Record(Searcher& s, const Trie* t) {
+  uint32_t word_id = t->WordId();
+  if (multiboggle_) {
+    if (s.found_paths.emplace((uint64_t(word_id) << 32) + s.used).second) {
+      found_[s.task].push_back({word_id, s.used, s.seq});
+    }
+    return;
+  }
+  // Lower first_task_ to this task, unless this or an earlier task has it.
+  auto& first = first_task_[word_id];
+  uint16_t cur = first.load(memory_order_relaxed);
+  while (cur > s.task) {
+    if (first.compare_exchange_weak(cur, s.task, memory_order_relaxed)) {
+      found_[s.task].push_back({word_id, s.used, s.seq});
+      return;
+    }
+  }
+}
+
+#endif  // PARALLEL_BOGGLER_H
@@ -0,0 +1,66 @@
+#include "perf_counters.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef __linux__
+static int OpenCounter(uint32_t type, uint64_t config) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* static */ unique_ptr<PerfCounter> PerfCounter::DTLBLoadMisses() {
+  int fd = OpenCounter(
+      PERF_TYPE_HW_CACHE,
+      PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+  );
+  if (fd < 0) {
+    perror("Couldn't open a dTLB miss counter");
+    return NULL;
+  }
+  return unique_ptr<PerfCounter>(new PerfCounter(fd));
+}
+
+void PerfCounter::Start() {
+  ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t PerfCounter::Stop() {
+  ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+  return Value();
+}
+
+uint64_t PerfCounter::Value() const {
+  uint64_t count = 0;
+  if (read(fd_, &count, sizeof(count)) != sizeof(count)) return 0;
+  return count;
+}
+#else
+/* static */ unique_ptr<PerfCounter> PerfCounter::DTLBLoadMisses() {
+  fprintf(stderr, "Performance counters are only supported on Linux\n");
+  return NULL;
+}
+
+void PerfCounter::Start() {}
+uint64_t PerfCounter::Stop() { return 0; }
+uint64_t PerfCounter::Value() const { return 0; }
+#endif
+
+PerfCounter::~PerfCounter() { close(fd_); }
@@ -0,0 +1,38 @@
+// Hardware performance counters, for benchmarks.
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+#include <memory>
+
+using namespace std;
+
+// Counts a hardware event for the calling thread (and threads it starts after
+// Start()) using perf_event_open. Linux only.
+//
+//   auto c = PerfCounter::DTLBLoadMisses();
+//   if (c) c->Start();
+//   ...
+//   if (c) printf("%lu dTLB misses\n", c->Stop());
+class PerfCounter {
+ public:
+  // Returns NULL (and logs) if the counter isn't available, e.g. on a VM that
+  // doesn't expose it or if /proc/sys/kernel/perf_event_paranoid forbids it.
+  static unique_ptr<PerfCounter> DTLBLoadMisses();
+  ~PerfCounter();
+
+  // Resets the count to zero and starts counting.
+  void Start();
+  // Stops counting and returns the count.
+  uint64_t Stop();
+  // The count so far.
+  uint64_t Value() const;
+
+ private:
+  PerfCounter(int fd) : fd_(fd) {}
+
+  int fd_;
+};
+
+#endif  // PERF_COUNTERS_H
@@ -0,0 +1,172 @@
+#include "sampling.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+
+using namespace std;
+
+// A uniformly random integer in [0, n).
+static inline uint64_t RandomBelow(mt19937_64& rng, uint64_t n) {
+  return (static_cast<unsigned __int128>(rng()) * n) >> 64;
+}
+
+static bool CheckLetters(const string& letters, const char* what) {
+  for (char c : letters) {
+    if (c < 'a' || c > 'z') {
+      fprintf(stderr, "Found unexpected letter '%c' in %s '%s'\n", c, what, letters.c_str());
+      return false;
+    }
+  }
+  if (letters.empty()) {
+    fprintf(stderr, "Got an empty %s\n", what);
+    return false;
+  }
+  return true;
+}
+
+/* static */ unique_ptr<BoardModel> BoardModel::FromLetters(const string& letters) {
+  if (!CheckLetters(letters, "letter list")) return NULL;
+  unique_ptr<BoardModel> model(new BoardModel);
+  model->letters_ = letters;
+  return model;
+}
+
+/* static */ unique_ptr<BoardModel> BoardModel::FromDice(const vector<string>& dice) {
+  if (dice.empty()) {
+    fprintf(stderr, "Need at least one die\n");
+    return NULL;
+  }
+  for (const auto& die : dice) {
+    if (!CheckLetters(die, "die")) return NULL;
+  }
+  unique_ptr<BoardModel> model(new BoardModel);
+  model->dice_ = dice;
+  return model;
+}
+
+bool BoardModel::CheckSize(int num_cells) const {
+  if (IsDice() && dice_.size() != num_cells) {
+    fprintf(stderr, "Need %d dice for this board size, got %zu\n", num_cells, dice_.size());
+    return false;
+  }
+  return true;
+}
+
+void BoardModel::Generate(mt19937_64& rng, int num_cells, char* out) const {
+  if (IsDice()) {
+    int order[MAX_CELLS];
+    for (int i = 0; i < num_cells; i++) order[i] = i;
+    for (int i = num_cells - 1; i > 0; i--) {
+      swap(order[i], order[RandomBelow(rng, i + 1)]);
+    }
+    for (int i = 0; i < num_cells; i++) {
+      const string& die = dice_[order[i]];
+      out[i] = die[RandomBelow(rng, die.size())];
+    }
+  } else {
+    for (int i = 0; i < num_cells; i++) {
+      out[i] = letters_[RandomBelow(rng, letters_.size())];
+    }
+  }
+  out[num_cells] = '\0';
+}
+
+// Orders (score, board) pairs from best to worst.
+static bool Better(const pair<int, string>& a, const pair<int, string>& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+bool SampleSummary::IsTopBoard(int score, const char* board) const {
+  if (top_.size() < top_k_) return true;
+  const auto& worst = top_.front();
+  return score > worst.first || (score == worst.first && worst.second.compare(board) > 0);
+}
+
+void SampleSummary::Add(int score, const char* board) {
+  if (score < 0) return;  // invalid board
+  num_boards_++;
+  if (score >= histogram_.size()) histogram_.resize(score + 1);
+  histogram_[score]++;
+  MaybeAddTopBoard(score, board);
+}
+
+void SampleSummary::MaybeAddTopBoard(int score, const char* board) {
+  if (top_k_ <= 0 || !IsTopBoard(score, board)) return;
+  if (top_.size() == top_k_) {
+    pop_heap(top_.begin(), top_.end(), Better);
+    top_.pop_back();
+  }
+  top_.emplace_back(score, board);
+  push_heap(top_.begin(), top_.end(), Better);
+}
+
+void SampleSummary::Merge(const SampleSummary& other) {
+  num_boards_ += other.num_boards_;
+  if (other.histogram_.size() > histogram_.size()) {
+    histogram_.resize(other.histogram_.size());
+  }
+  for (size_t s = 0; s < other.histogram_.size(); s++) {
+    histogram_[s] += other.histogram_[s];
+  }
+  for (const auto& [score, board] : other.top_) {
+    MaybeAddTopBoard(score, board.c_str());
+  }
+}
+
+double SampleSummary::Mean() const {
+  if (!num_boards_) return 0;
+  double sum = 0;
+  for (size_t s = 0; s < histogram_.size(); s++) sum += double(s) * histogram_[s];
+  return sum / num_boards_;
+}
+
+double SampleSummary::StdDev() const {
+  if (!num_boards_) return 0;
+  double mean = Mean();
+  double sum_sq = 0;
+  for (size_t s = 0; s < histogram_.size(); s++) {
+    sum_sq += (s - mean) * (s - mean) * histogram_[s];
+  }
+  return sqrt(sum_sq / num_boards_);
+}
+
+int SampleSummary::MinScore() const {
+  for (size_t s = 0; s < histogram_.size(); s++) {
+    if (histogram_[s]) return s;
+  }
+  return -1;
+}
+
+int SampleSummary::MaxScore() const {
+  for (int s = int(histogram_.size()) - 1; s >= 0; s--) {
+    if (histogram_[s]) return s;
+  }
+  return -1;
+}
+
+int SampleSummary::Percentile(double p) const {
+  if (!num_boards_) return -1;
+  double target = max(1.0, ceil(p * num_boards_));
+  uint64_t count = 0;
+  for (size_t s = 0; s < histogram_.size(); s++) {
+    count += histogram_[s];
+    if (count >= target) return s;
+  }
+  return MaxScore();
+}
+
+uint64_t SampleSummary::CountAtLeast(int score) const {
+  uint64_t count = 0;
+  for (size_t s = max(score, 0); s < histogram_.size(); s++) count += histogram_[s];
+  return count;
+}
+
+vector<pair<int, string>> SampleSummary::TopBoards() const {
+  vector<pair<int, string>> top = top_;
+  sort(top.begin(), top.end(), Better);
+  return top;
+}
@@ -0,0 +1,77 @@
+// Random board models and summaries of their scores, used by ScoreSampler.
+// These don't depend on the board size, so they live apart from the templates.
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// How to generate a random board.
+class BoardModel {
+ public:
+  // Each cell is drawn independently and uniformly from letters. Repeat a
+  // letter to make it more likely.
+  static unique_ptr<BoardModel> FromLetters(const string& letters);
+  // The dice are shuffled onto the cells and each one shows a random face.
+  // There must be exactly one die per cell. Use "q" for the "Qu" face.
+  static unique_ptr<BoardModel> FromDice(const vector<string>& dice);
+
+  bool IsDice() const { return !dice_.empty(); }
+  // Returns false (and logs) if the model can't fill a board of this size.
+  bool CheckSize(int num_cells) const;
+  // Writes num_cells letters and a terminating NUL to out.
+  void Generate(mt19937_64& rng, int num_cells, char* out) const;
+
+ private:
+  BoardModel() {}
+
+  string letters_;
+  vector<string> dice_;
+};
+
+// Summary of the scores of many boards. Each sampler thread fills in its own
+// and they're merged at the end. Scores are small integers, so this keeps an
+// exact histogram rather than an approximate quantile sketch: it's mergeable,
+// takes a few KB and gives exact percentiles.
+class SampleSummary {
+ public:
+  explicit SampleSummary(int top_k) : top_k_(top_k), num_boards_(0) {}
+
+  void Add(int score, const char* board);
+  void Merge(const SampleSummary& other);
+
+  uint64_t NumBoards() const { return num_boards_; }
+  double Mean() const;
+  double StdDev() const;
+  int MinScore() const;
+  int MaxScore() const;
+  // The smallest score s such that at least a fraction p of boards score <= s.
+  int Percentile(double p) const;
+  // Number of boards that scored at least this much.
+  uint64_t CountAtLeast(int score) const;
+  // histogram[s] is the number of boards that scored s.
+  const vector<uint64_t>& Histogram() const { return histogram_; }
+  // The highest-scoring boards seen, best first. Ties go to the board that
+  // comes first alphabetically, so this doesn't depend on scoring order.
+  vector<pair<int, string>> TopBoards() const;
+
+ private:
+  // Is (score, board) better than the worst of the current top boards?
+  bool IsTopBoard(int score, const char* board) const;
+  void MaybeAddTopBoard(int score, const char* board);
+
+  int top_k_;
+  uint64_t num_boards_;
+  vector<uint64_t> histogram_;
+  // A heap with the worst of the top boards at the front.
+  vector<pair<int, string>> top_;
+};
+
+#endif  // SAMPLING_H
@@ -0,0 +1,83 @@
+// Estimates the distribution of scores for random boards.
+#ifndef SCORE_SAMPLER_H
+#define SCORE_SAMPLER_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "concurrent_boggler.h"
+#include "sampling.h"
+#include "trie.h"
+
+using namespace std;
+
+// Scores random boards across many threads. Given the same seed and number of
+// threads, the results are identical from run to run: each thread draws from
+// its own generator and scores a fixed share of the boards.
+template <int M, int N>
+class ScoreSampler {
+ public:
+  ScoreSampler(const Trie* t) : dict_(t) {}
+
+  // num_threads=0 means one per core. Returns NULL for an invalid model.
+  unique_ptr<SampleSummary> Sample(
+      const BoardModel& model,
+      uint64_t num_boards,
+      uint64_t seed,
+      int num_threads,
+      int top_k
+  );
+
+ private:
+  const Trie* dict_;
+};
+
+// Seed for the generator of thread i.
+inline uint64_t SamplerThreadSeed(uint64_t seed, int thread_index) {
+  // splitmix64, so nearby seeds and thread indices give unrelated streams.
+  uint64_t z = seed + (thread_index + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+template <int M, int N>
+unique_ptr<SampleSummary> ScoreSampler<M, N>::Sample(
+    const BoardModel& model,
+    uint64_t num_boards,
+    uint64_t seed,
+    int num_threads,
+    int top_k
+) {
+  if (!model.CheckSize(M * N)) return NULL;
+  if (num_threads <= 0) num_threads = max(1u, thread::hardware_concurrency());
+
+  // Each thread fills in its own summary and only writes it here at the end.
+  vector<SampleSummary> summaries(num_threads, SampleSummary(top_k));
+  vector<thread> threads;
+  for (int ti = 0; ti < num_threads; ti++) {
+    uint64_t n = num_boards / num_threads + (ti < num_boards % num_threads);
+    threads.emplace_back([&, ti, n]() {
+      mt19937_64 rng(SamplerThreadSeed(seed, ti));
+      ConcurrentBoggler<M, N> boggler(dict_);
+      SampleSummary summary(top_k);
+      char board[M * N + 1];
+      for (uint64_t i = 0; i < n; i++) {
+        model.Generate(rng, M * N, board);
+        summary.Add(boggler.Score(board), board);
+      }
+      summaries[ti] = move(summary);
+    });
+  }
+  for (auto& th : threads) th.join();
+
+  unique_ptr<SampleSummary> out(new SampleSummary(top_k));
+  for (const auto& summary : summaries) out->Merge(summary);
+  return out;
+}
+
+#endif  // SCORE_SAMPLER_H
@@ -0,0 +1,192 @@
+// Wire format shared by boggle_server and BoggleClient.
+//
+// Every message is a frame: a little-endian uint32 with the number of bytes
+// that follow, then a fixed header, then an op-specific payload.
+//
+//   Request:  length | request_id:u32 | op:u8 | width:u8 | height:u8 | flags:u8 | board
+//   Response: length | request_id:u32 | op:u8 | status:u8 | reserved:u16 | payload
+//
+// Clients may pipeline requests without waiting, but the server stops reading
+// from a client that has too many requests outstanding or too many unread
+// responses until it catches up. Responses carry the request_id they answer
+// and may arrive out of order.
+//
+// Payloads:
+//   kScore:      i32 score
+//   kFindWords:  u32 num_paths, then per path u8 length and that many u8 cells.
+//                Set kMultiboggle in flags to get every distinct set of cells
+//                that spells a word, not just one path per word.
+//   kStats:      ServerStats (the request has no board; width = height = 0)
+#ifndef SERVER_PROTOCOL_H
+#define SERVER_PROTOCOL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace server_protocol {
+
+enum Op : uint8_t {
+  kScore = 1,
+  kFindWords = 2,
+  kStats = 3,
+};
+
+enum Flags : uint8_t {
+  kMultiboggle = 1,
+};
+
+enum Status : uint8_t {
+  kOk = 0,
+  kBadRequest = 1,  // unknown op, unsupported size or invalid board
+};
+
+const size_t kRequestHeaderSize = 8;   // after the length
+const size_t kResponseHeaderSize = 8;  // after the length
+// Frames longer than this are a protocol error and close the connection.
+const uint32_t kMaxFrameSize = 1 << 20;
+
+struct Request {
+  uint32_t request_id = 0;
+  uint8_t op = 0;
+  uint8_t width = 0;
+  uint8_t height = 0;
+  uint8_t flags = 0;
+  string board;
+};
+
+struct Response {
+  uint32_t request_id = 0;
+  uint8_t op = 0;
+  uint8_t status = kOk;
+  string payload;
+};
+
+// Latencies are measured on the server, from when a request has been read to
+// when its response has been computed.
+struct ServerStats {
+  uint64_t requests = 0;
+  uint64_t batches = 0;
+  uint64_t queue_depth = 0;
+  uint64_t max_queue_depth = 0;
+  uint64_t p50_us = 0;
+  uint64_t p90_us = 0;
+  uint64_t p99_us = 0;
+  uint64_t p999_us = 0;
+  uint64_t max_us = 0;
+};
+
+inline void PutU32(string* out, uint32_t v) {
+  char b[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+  out->append(b, 4);
+}
+
+inline void PutU64(string* out, uint64_t v) {
+  PutU32(out, uint32_t(v));
+  PutU32(out, uint32_t(v >> 32));
+}
+
+inline uint32_t GetU32(const char* p) {
+  const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+  return u[0] | (u[1] << 8) | (u[2] << 16) | (uint32_t(u[3]) << 24);
+}
+
+inline uint64_t GetU64(const char* p) {
+  return GetU32(p) | (uint64_t(GetU32(p + 4)) << 32);
+}
+
+inline void EncodeRequest(const Request& req, string* out) {
+  PutU32(out, kRequestHeaderSize + req.board.size());
+  PutU32(out, req.request_id);
+  out->push_back(req.op);
+  out->push_back(req.width);
+  out->push_back(req.height);
+  out->push_back(req.flags);
+  out->append(req.board);
+}
+
+inline void EncodeResponse(const Response& resp, string* out) {
+  PutU32(out, kResponseHeaderSize + resp.payload.size());
+  PutU32(out, resp.request_id);
+  out->push_back(resp.op);
+  out->push_back(resp.status);
+  out->append(2, '\0');
+  out->append(resp.payload);
+}
+
+// If buf starts with a complete frame, returns its total size (including the
+// length) and sets *body to the bytes after the length. Returns 0 if more data
+// is needed and -1 for a malformed frame.
+inline int64_t NextFrame(const char* buf, size_t size, size_t header_size, const char** body) {
+  if (size < 4) return 0;
+  uint32_t len = GetU32(buf);
+  if (len < header_size || len > kMaxFrameSize) return -1;
+  if (size < 4 + len) return 0;
+  *body = buf + 4;
+  return 4 + len;
+}
+
+inline void DecodeRequest(const char* body, size_t len, Request* req) {
+  req->request_id = GetU32(body);
+  req->op = body[4];
+  req->width = body[5];
+  req->height = body[6];
+  req->flags = body[7];
+  req->board.assign(body + kRequestHeaderSize, len - kRequestHeaderSize);
+}
+
+inline void DecodeResponse(const char* body, size_t len, Response* resp) {
+  resp->request_id = GetU32(body);
+  resp->op = body[4];
+  resp->status = body[5];
+  resp->payload.assign(body + kResponseHeaderSize, len - kResponseHeaderSize);
+}
+
+inline void EncodePaths(const vector<vector<int>>& paths, string* out) {
+  PutU32(out, paths.size());
+  for (const auto& path : paths) {
+    out->push_back(char(path.size()));
+    for (int cell : path) out->push_back(char(cell));
+  }
+}
+
+// Returns false if the payload is truncated.
+inline bool DecodePaths(const string& payload, vector<vector<int>>* paths) {
+  if (payload.size() < 4) return false;
+  uint32_t n = GetU32(payload.data());
+  size_t pos = 4;
+  paths->clear();
+  for (uint32_t i = 0; i < n; i++) {
+    if (pos >= payload.size()) return false;
+    size_t len = uint8_t(payload[pos++]);
+    if (pos + len > payload.size()) return false;
+    vector<int> path;
+    for (size_t j = 0; j < len; j++) path.push_back(uint8_t(payload[pos++]));
+    paths->push_back(path);
+  }
+  return true;
+}
+
+inline void EncodeStats(const ServerStats& s, string* out) {
+  for (uint64_t v : {s.requests, s.batches, s.queue_depth, s.max_queue_depth, s.p50_us,
+                     s.p90_us, s.p99_us, s.p999_us, s.max_us}) {
+    PutU64(out, v);
+  }
+}
+
+inline bool DecodeStats(const string& payload, ServerStats* s) {
+  uint64_t* fields[] = {&s->requests, &s->batches, &s->queue_depth, &s->max_queue_depth,
+                        &s->p50_us, &s->p90_us, &s->p99_us, &s->p999_us, &s->max_us};
+  const size_t num_fields = sizeof(fields) / sizeof(fields[0]);
+  if (payload.size() != 8 * num_fields) return false;
+  for (size_t i = 0; i < num_fields; i++) *fields[i] = GetU64(payload.data() + 8 * i);
+  return true;
+}
+
+}  // namespace server_protocol
+
+#endif  // SERVER_PROTOCOL_H
@@ -1,20 +1,171 @@
 #include "trie.h"
 
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <numeric>
 #include <queue>
+#include <string_view>
+#include <thread>
 #include <utility>
 
 using namespace std;
 
 static inline int idx(char x) { return x - 'a'; }
 
-// Global counter for tracking Trie memory usage
-static size_t g_trie_bytes_allocated = 0;
+namespace
+{
+const size_t kHugePageSize = 2 << 20;
+
+enum PageKind
+{
+  kRegularPages,
+  kTransparentHugePages,
+  kHugeTLBPages,
+  kNumPageKinds
+};
+
+bool TransparentHugePagesEnabled()
+{
+  static const bool enabled = []() {
+    FILE *f = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!f)
+      return false;
+    char buf[128] = {0};
+    bool ok = fgets(buf, sizeof(buf), f) && !strstr(buf, "[never]");
+    fclose(f);
+    return ok;
+  }();
+  return enabled;
+}
+
+// Maps bytes (a multiple of kHugePageSize) of zeroed memory aligned to a huge
+// page. This uses reserved huge pages (MAP_HUGETLB) if there are any left,
+// then transparent huge pages, then regular pages. Returns NULL on failure.
+void *MapHugePages(size_t bytes, PageKind *kind)
+{
+#ifdef MAP_HUGETLB
+  void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (p != MAP_FAILED)
+  {
+    *kind = kHugeTLBPages;
+    return p;
+  }
+#endif
+  // Map an extra huge page so that the region can be aligned, then trim it.
+  size_t padded = bytes + kHugePageSize;
+  void *m = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (m == MAP_FAILED)
+    return NULL;
+  char *raw = static_cast<char *>(m);
+  char *aligned = reinterpret_cast<char *>(
+      (reinterpret_cast<uintptr_t>(raw) + kHugePageSize - 1) & ~(kHugePageSize - 1));
+  if (aligned > raw)
+    munmap(raw, aligned - raw);
+  size_t tail = (raw + padded) - (aligned + bytes);
+  if (tail)
+    munmap(aligned + bytes, tail);
+  *kind = kRegularPages;
+#ifdef MADV_HUGEPAGE
+  if (madvise(aligned, bytes, MADV_HUGEPAGE) == 0 && TransparentHugePagesEnabled())
+    *kind = kTransparentHugePages;
+#endif
+  return aligned;
+}
+
+// A contiguous run of pooled nodes.
+struct NodeRegion
+{
+  Trie *nodes;
+  size_t size;         // nodes handed out so far
+  size_t capacity;
+  size_t mapped_bytes; // 0 if the region came from operator new
+};
+} // namespace
+
+struct TrieRootData
+{
+  // Guards stats, which may be read while words are being added.
+  mutable mutex stats_mutex;
+  TrieStats stats;
+  // The id for the next word added via the root.
+  uint32_t next_word_id = 0;
+
+  // If set, nodes added via the root are pooled in regions on huge pages
+  // rather than allocated one at a time.
+  bool huge_pages = false;
+  // Memory for pooled nodes: the block built by CreateFromFileBulk or, with
+  // huge_pages, every node other than the root.
+  vector<NodeRegion> regions;
+  size_t mapped_bytes[kNumPageKinds] = {0};
+
+  // Returns space for n contiguous nodes, which the caller must construct.
+  Trie *AllocateNodes(size_t n);
+
+  ~TrieRootData()
+  {
+    for (const auto &r : regions)
+    {
+      for (size_t i = 0; i < r.size; i++)
+        r.nodes[i].~Trie();
+      if (r.mapped_bytes)
+        munmap(r.nodes, r.mapped_bytes);
+      else
+        ::operator delete(r.nodes);
+    }
+  }
+};
+
+Trie *TrieRootData::AllocateNodes(size_t n)
+{
+  if (!regions.empty())
+  {
+    NodeRegion &r = regions.back();
+    if (r.capacity - r.size >= n)
+    {
+      Trie *nodes = r.nodes + r.size;
+      r.size += n;
+      return nodes;
+    }
+  }
+
+  NodeRegion r = {NULL, n, n, 0};
+  if (huge_pages)
+  {
+    size_t bytes = max(n * sizeof(Trie), kHugePageSize);
+    bytes = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    PageKind kind;
+    void *m = MapHugePages(bytes, &kind);
+    if (m)
+    {
+      r.nodes = static_cast<Trie *>(m);
+      r.capacity = bytes / sizeof(Trie);
+      r.mapped_bytes = bytes;
+      mapped_bytes[kind] += bytes;
+    }
+  }
+  if (!r.nodes)
+    r.nodes = static_cast<Trie *>(::operator new(n * sizeof(Trie)));
+  regions.push_back(r);
+  return r.nodes;
+}
+
+static double MillisecondsSince(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
 
 // Helper function to format bytes in human-readable form
 static string FormatBytes(size_t bytes)
@@ -41,39 +192,235 @@ static string FormatBytes(size_t bytes)
   return string(buffer);
 }
 
+static void LogLoad(
+    const TrieStats &stats, chrono::steady_clock::time_point start, const string &extra = "")
+{
+  fprintf(
+      stderr,
+      "Loaded %zu words into Trie with %zu nodes using %zu bytes %s (%zu bytes per node) in %.1f ms%s\n",
+      stats.num_words,
+      stats.num_nodes,
+      stats.bytes,
+      FormatBytes(stats.bytes).c_str(),
+      sizeof(Trie),
+      MillisecondsSince(start),
+      extra.c_str());
+}
+
+double TrieStats::AverageChildren() const
+{
+  size_t parents = 0;
+  for (const auto &counts : child_counts_at_depth)
+    parents += accumulate(counts.begin() + 1, counts.end(), size_t(0));
+  return parents ? static_cast<double>(num_nodes - 1) / parents : 0.0;
+}
+
+void TrieStats::AddNode(int depth)
+{
+  if (nodes_at_depth.size() <= depth)
+  {
+    nodes_at_depth.resize(depth + 1);
+    words_at_depth.resize(depth + 1);
+    child_counts_at_depth.resize(depth + 1);
+  }
+  num_nodes++;
+  bytes += sizeof(Trie);
+  nodes_at_depth[depth]++;
+  child_counts_at_depth[depth][0]++;
+}
+
+void TrieStats::AddChild(int depth, int old_num_children)
+{
+  child_counts_at_depth[depth][old_num_children]--;
+  child_counts_at_depth[depth][old_num_children + 1]++;
+}
+
+void TrieStats::AddWord(int depth)
+{
+  num_words++;
+  words_at_depth[depth]++;
+}
+
+void TrieStats::Merge(const TrieStats &other)
+{
+  size_t depth = max(nodes_at_depth.size(), other.nodes_at_depth.size());
+  nodes_at_depth.resize(depth);
+  words_at_depth.resize(depth);
+  child_counts_at_depth.resize(depth);
+  for (size_t d = 0; d < other.nodes_at_depth.size(); d++)
+  {
+    nodes_at_depth[d] += other.nodes_at_depth[d];
+    words_at_depth[d] += other.words_at_depth[d];
+    for (int k = 0; k <= kNumLetters; k++)
+      child_counts_at_depth[d][k] += other.child_counts_at_depth[d][k];
+  }
+  bytes += other.bytes;
+  num_nodes += other.num_nodes;
+  num_words += other.num_words;
+}
+
 // Initially, this node is empty
-Trie::Trie()
+Trie::Trie() : Trie(false)
+{
+  root_data_.reset(new TrieRootData);
+  root_data_->stats.AddNode(0);
+}
+
+Trie::Trie(bool pooled)
 {
   for (int i = 0; i < kNumLetters; i++)
     children_[i] = NULL;
   is_word_ = false;
+  pooled_ = pooled;
+  min_remaining_ = kNoWordBelow;
+  max_remaining_ = 0;
   mark_ = 0;
-  g_trie_bytes_allocated += sizeof(Trie);
+  word_id_ = 0;
+}
+
+/* static */ unique_ptr<Trie> Trie::CreateRoot(bool huge_pages)
+{
+  unique_ptr<Trie> t(new Trie);
+  t->root_data_->huge_pages = huge_pages;
+  return t;
+}
+
+int64_t Trie::MaxWordId() const
+{
+  int64_t max_id = IsWord() ? int64_t(word_id_) : -1;
+  for (int i = 0; i < kNumLetters; i++)
+  {
+    if (StartsWord(i))
+      max_id = max(max_id, Descend(i)->MaxWordId());
+  }
+  return max_id;
+}
+
+int Trie::NumChildren() const
+{
+  int count = 0;
+  for (int i = 0; i < kNumLetters; i++)
+    if (StartsWord(i))
+      count++;
+  return count;
 }
 
 Trie *Trie::AddWord(const char *wd)
 {
   if (!wd)
     return NULL;
-  if (!*wd)
+  TrieStats *stats = NULL;
+  unique_lock<mutex> lock;
+  if (root_data_)
   {
-    SetIsWord();
-    return this;
+    lock = unique_lock<mutex>(root_data_->stats_mutex);
+    stats = &root_data_->stats;
   }
-  int c = idx(*wd);
-  if (!StartsWord(c))
-    children_[c] = new Trie;
-  return Descend(c)->AddWord(wd + 1);
+
+  const char *word = wd;
+  Trie *t = this;
+  int depth = 0;
+  for (; *wd; wd++, depth++)
+  {
+    int c = idx(*wd);
+    if (!t->StartsWord(c))
+    {
+      if (stats)
+      {
+        stats->AddChild(depth, t->NumChildren());
+        stats->AddNode(depth + 1);
+      }
+      if (root_data_ && root_data_->huge_pages)
+        t->children_[c] = new (root_data_->AllocateNodes(1)) Trie(true);
+      else
+        t->children_[c] = new Trie(false);
+    }
+    t = t->Descend(c);
+  }
+  if (stats && !t->IsWord())
+    stats->AddWord(depth);
+  // Every call takes the next id, even for a word that's already there, so ids
+  // are positions in the word list just as with CreateFromFileBulk.
+  if (root_data_)
+    t->word_id_ = root_data_->next_word_id++;
+  t->SetIsWord();
+
+  // Every node on the path is now at most depth - d letters from a word.
+  Trie *p = this;
+  for (int d = 0; d <= depth; d++)
+  {
+    p->NoteWordBelow(depth - d);
+    if (d < depth)
+      p = p->Descend(idx(word[d]));
+  }
+  return t;
+}
+
+void Trie::NoteWordBelow(int distance)
+{
+  distance = min(distance, kNoWordBelow - 1);
+  min_remaining_ = min<int>(min_remaining_, distance);
+  max_remaining_ = max<int>(max_remaining_, distance);
 }
 
 Trie::~Trie()
 {
   for (int i = 0; i < kNumLetters; i++)
   {
-    if (children_[i])
+    // Pooled nodes are freed along with the root.
+    if (children_[i] && !children_[i]->pooled_)
       delete children_[i];
   }
-  g_trie_bytes_allocated -= sizeof(Trie);
+}
+
+TrieStats Trie::Stats() const
+{
+  if (root_data_)
+  {
+    lock_guard<mutex> lock(root_data_->stats_mutex);
+    TrieStats stats = root_data_->stats;
+    // Regions on huge pages are rounded up to whole pages, all of which count.
+    for (const auto &r : root_data_->regions)
+      if (r.mapped_bytes)
+        stats.bytes += r.mapped_bytes - r.size * sizeof(Trie);
+    return stats;
+  }
+  TrieStats stats;
+  AccumulateStats(0, &stats);
+  return stats;
+}
+
+string Trie::NodePlacement() const
+{
+  if (!root_data_ || !root_data_->huge_pages)
+    return "heap";
+  const char *names[kNumPageKinds] = {"regular", "thp", "hugetlb"};
+  string placement;
+  for (int kind = kNumPageKinds - 1; kind >= 0; kind--)
+  {
+    if (!root_data_->mapped_bytes[kind])
+      continue;
+    if (!placement.empty())
+      placement += "+";
+    placement += names[kind];
+  }
+  return placement.empty() ? "heap" : placement;
+}
+
+void Trie::AccumulateStats(int depth, TrieStats *stats) const
+{
+  stats->AddNode(depth);
+  if (IsWord())
+    stats->AddWord(depth);
+  int num_children = 0;
+  for (int i = 0; i < kNumLetters; i++)
+  {
+    if (StartsWord(i))
+    {
+      stats->AddChild(depth, num_children++);
+      Descend(i)->AccumulateStats(depth + 1, stats);
+    }
+  }
 }
 
 size_t Trie::Size()
@@ -168,8 +515,14 @@ Trie *Trie::FindWordId(int word_id)
   return nullptr;
 }
 
-unique_ptr<Trie> Trie::CreateFromFile(const char *filename)
+static string PlacementNote(const Trie &t, bool huge_pages)
 {
+  return huge_pages ? " (nodes on " + t.NodePlacement() + " pages)" : "";
+}
+
+unique_ptr<Trie> Trie::CreateFromFile(const char *filename, bool huge_pages)
+{
+  auto start = chrono::steady_clock::now();
   char line[80];
   FILE *f = fopen(filename, "r");
   if (!f)
@@ -178,29 +531,17 @@ unique_ptr<Trie> Trie::CreateFromFile(const char *filename)
     return NULL;
   }
 
-  size_t bytes_before = g_trie_bytes_allocated;
-  int count = 0;
-  unique_ptr<Trie> t(new Trie);
-  while (!feof(f) && fscanf(f, "%s", line))
+  unique_ptr<Trie> t = CreateRoot(huge_pages);
+  while (fscanf(f, "%s", line) == 1)
   {
     if (BogglifyWord(line))
     {
-      t->AddWord(line)->SetWordId(count++);
+      t->AddWord(line);
     }
   }
   fclose(f);
 
-  size_t bytes_used = g_trie_bytes_allocated - bytes_before;
-  size_t num_nodes = t->NumNodes();
-  fprintf(
-      stderr,
-      "Loaded %d words into Trie with %zu nodes using %zu bytes %s (%zu bytes per node)\n",
-      count,
-      num_nodes,
-      bytes_used,
-      FormatBytes(bytes_used).c_str(),
-      bytes_used / num_nodes);
-
+  LogLoad(t->Stats(), start, PlacementNote(*t, huge_pages));
   return t;
 }
 
@@ -209,9 +550,8 @@ unique_ptr<Trie> Trie::CreateFromFileStr(const string &filename)
   return CreateFromFile(filename.c_str());
 }
 
-/* static */ bool Trie::IsBoggleWord(const char *wd)
+static bool IsBoggleWordOfLength(const char *wd, size_t size)
 {
-  int size = strlen(wd);
   if (size < 3)
     return false;
   for (int i = 0; i < size; ++i)
@@ -225,6 +565,11 @@ unique_ptr<Trie> Trie::CreateFromFileStr(const string &filename)
   return true;
 }
 
+/* static */ bool Trie::IsBoggleWord(const char *wd)
+{
+  return IsBoggleWordOfLength(wd, strlen(wd));
+}
+
 /* static */ bool Trie::BogglifyWord(char *word)
 {
   if (!IsBoggleWord(word))
@@ -240,25 +585,274 @@ unique_ptr<Trie> Trie::CreateFromFileStr(const string &filename)
   return true;
 }
 
-/* static */ unique_ptr<Trie> Trie::CreateFromWordlist(const vector<string> &words)
+/* static */ unique_ptr<Trie> Trie::CreateFromWordlist(const vector<string> &words, bool huge_pages)
 {
-  size_t bytes_before = g_trie_bytes_allocated;
-  int count = 0;
-  unique_ptr<Trie> t(new Trie);
+  auto start = chrono::steady_clock::now();
+  unique_ptr<Trie> t = CreateRoot(huge_pages);
   for (const auto &word : words)
   {
-    t->AddWord(word.c_str())->SetWordId(count++);
+    t->AddWord(word.c_str());
   }
 
-  size_t bytes_used = g_trie_bytes_allocated - bytes_before;
-  size_t num_nodes = t->NumNodes();
-  fprintf(
-      stderr,
-      "Loaded %d words into Trie with %zu nodes using %s (%zu bytes per node)\n",
-      count,
-      num_nodes,
-      FormatBytes(bytes_used).c_str(),
-      bytes_used / num_nodes);
+  LogLoad(t->Stats(), start, PlacementNote(*t, huge_pages));
+  return t;
+}
+
+namespace
+{
+inline bool IsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Writes the word with "qu" replaced by "q" and returns its new length.
+size_t BogglifySpan(string_view w, char *out)
+{
+  size_t dst = 0;
+  for (size_t src = 0; src < w.size(); src++, dst++)
+  {
+    out[dst] = w[src];
+    if (w[src] == 'q')
+      src += 1;
+  }
+  return dst;
+}
+
+size_t CommonPrefixLength(const char *a, size_t a_len, const char *b, size_t b_len)
+{
+  size_t n = min(a_len, b_len);
+  size_t i = 0;
+  while (i < n && a[i] == b[i])
+    i++;
+  return i;
+}
+
+// Calls fn(0) ... fn(num_tasks - 1) across up to num_threads threads.
+void RunTasks(int num_tasks, int num_threads, const function<void(int)> &fn)
+{
+  num_threads = min(num_threads, num_tasks);
+  if (num_threads <= 1)
+  {
+    for (int i = 0; i < num_tasks; i++)
+      fn(i);
+    return;
+  }
+  atomic<int> next_task(0);
+  vector<thread> threads;
+  for (int t = 0; t < num_threads; t++)
+  {
+    threads.emplace_back([&]() {
+      for (int i = next_task++; i < num_tasks; i = next_task++)
+        fn(i);
+    });
+  }
+  for (auto &th : threads)
+    th.join();
+}
+} // namespace
+
+/* static */ unique_ptr<Trie> Trie::CreateFromFileBulk(
+    const char *filename, int num_threads, bool huge_pages)
+{
+  auto start = chrono::steady_clock::now();
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr, "Couldn't open %s\n", filename);
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    fprintf(stderr, "Couldn't stat %s\n", filename);
+    close(fd);
+    return NULL;
+  }
+  size_t file_size = st.st_size;
+  const char *data = NULL;
+  if (file_size > 0)
+  {
+    void *m = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (m == MAP_FAILED)
+    {
+      fprintf(stderr, "Couldn't mmap %s\n", filename);
+      close(fd);
+      return NULL;
+    }
+    data = static_cast<const char *>(m);
+  }
+  close(fd);
+
+  // Split the file into Boggle words. Word ids match CreateFromFile.
+  vector<string_view> words;
+  bool sorted = true;
+  for (const char *p = data, *end = data + file_size; p < end;)
+  {
+    while (p < end && IsSpace(*p))
+      p++;
+    const char *word_start = p;
+    while (p < end && !IsSpace(*p))
+      p++;
+    string_view w(word_start, p - word_start);
+    if (!IsBoggleWordOfLength(w.data(), w.size()))
+      continue;
+    if (!words.empty() && w < words.back())
+    {
+      sorted = false;
+      break;
+    }
+    words.push_back(w);
+  }
+  if (!sorted)
+  {
+    if (data)
+      munmap(const_cast<char *>(data), file_size);
+    fprintf(stderr, "%s is not sorted; falling back to CreateFromFile\n", filename);
+    return CreateFromFile(filename, huge_pages);
+  }
+
+  if (num_threads <= 0)
+    num_threads = max(1u, thread::hardware_concurrency());
+  unique_ptr<Trie> t = BuildFromSortedWords(words, NULL, num_threads, huge_pages);
+  if (data)
+    munmap(const_cast<char *>(data), file_size);
+
+  LogLoad(
+      t->Stats(), start, " (" + to_string(num_threads) + " threads)" + PlacementNote(*t, huge_pages));
+  return t;
+}
+
+/* static */ unique_ptr<Trie> Trie::CreateFromSortedWords(
+    const vector<string> &words, const vector<uint32_t> &word_ids, int num_threads)
+{
+  if (word_ids.size() != words.size())
+  {
+    fprintf(stderr, "Got %zu words but %zu word ids\n", words.size(), word_ids.size());
+    return NULL;
+  }
+  vector<string_view> spans;
+  spans.reserve(words.size());
+  for (const auto &word : words)
+  {
+    if (!IsBoggleWord(word.c_str()))
+    {
+      fprintf(stderr, "'%s' is not a Boggle word\n", word.c_str());
+      return NULL;
+    }
+    if (!spans.empty() && word <= spans.back())
+    {
+      fprintf(stderr, "Words must be sorted and unique ('%s')\n", word.c_str());
+      return NULL;
+    }
+    spans.push_back(word);
+  }
+  if (num_threads <= 0)
+    num_threads = max(1u, thread::hardware_concurrency());
+  return BuildFromSortedWords(spans, word_ids.data(), num_threads, false);
+}
+
+/* static */ unique_ptr<Trie> Trie::BuildFromSortedWords(
+    const vector<string_view> &words, const uint32_t *word_ids, int num_threads, bool huge_pages)
+{
+  size_t max_len = 0;
+  for (const auto &w : words)
+    max_len = max(max_len, w.size());
+
+  // Removing the "u" after each "q" preserves the sort order, so the words for
+  // each first letter are contiguous. Each letter can be built independently.
+  size_t group_start[kNumLetters + 1];
+  size_t w = 0;
+  for (int c = 0; c < kNumLetters; c++)
+  {
+    group_start[c] = w;
+    while (w < words.size() && idx(words[w][0]) == c)
+      w++;
+  }
+  group_start[kNumLetters] = w;
 
+  // Each word adds one node per letter beyond its common prefix with the
+  // previous word. Count these first so that all nodes go into one block.
+  size_t group_nodes[kNumLetters];
+  RunTasks(kNumLetters, num_threads, [&](int c) {
+    vector<char> prev(max_len), cur(max_len);
+    size_t prev_len = 0, count = 0;
+    for (size_t i = group_start[c]; i < group_start[c + 1]; i++)
+    {
+      size_t len = BogglifySpan(words[i], cur.data());
+      count += len - CommonPrefixLength(prev.data(), prev_len, cur.data(), len);
+      swap(prev, cur);
+      prev_len = len;
+    }
+    group_nodes[c] = count;
+  });
+
+  size_t group_offset[kNumLetters + 1];
+  group_offset[0] = 0;
+  for (int c = 0; c < kNumLetters; c++)
+    group_offset[c + 1] = group_offset[c] + group_nodes[c];
+  size_t num_block_nodes = group_offset[kNumLetters];
+
+  unique_ptr<Trie> t = CreateRoot(huge_pages);
+  Trie *block = t->root_data_->AllocateNodes(num_block_nodes);
+  Trie *root = t.get();
+
+  // Build each letter's subtree in order, keeping the path to the previous word
+  // on a stack. Only the thread for letter c touches root->children_[c].
+  TrieStats group_stats[kNumLetters];
+  RunTasks(kNumLetters, num_threads, [&](int c) {
+    vector<char> prev(max_len), cur(max_len);
+    vector<Trie *> path(max_len + 1);
+    vector<int> num_children(max_len + 1);  // of each node on the path
+    path[0] = root;
+    size_t prev_len = 0;
+    Trie *next = block + group_offset[c];
+    TrieStats &stats = group_stats[c];
+    for (size_t i = group_start[c]; i < group_start[c + 1]; i++)
+    {
+      size_t len = BogglifySpan(words[i], cur.data());
+      size_t d = CommonPrefixLength(prev.data(), prev_len, cur.data(), len);
+      for (; d < len; d++)
+      {
+        Trie *node = new (next++) Trie(true);
+        path[d]->children_[idx(cur[d])] = node;
+        path[d + 1] = node;
+        // The root's children are counted once all groups are done.
+        if (d > 0)
+          stats.AddChild(d, num_children[d]++);
+        stats.AddNode(d + 1);
+        num_children[d + 1] = 0;
+      }
+      if (!path[len]->is_word_)
+        stats.AddWord(len);
+      path[len]->is_word_ = true;
+      // The root is shared by all the groups, so it's done at the end.
+      for (size_t p = 1; p <= len; p++)
+        path[p]->NoteWordBelow(len - p);
+      path[len]->word_id_ = word_ids ? word_ids[i] : i;
+      swap(prev, cur);
+      prev_len = len;
+    }
+    assert(next == block + group_offset[c + 1]);
+  });
+
+  uint32_t &next_word_id = t->root_data_->next_word_id;
+  next_word_id = words.size();
+  if (word_ids)
+    for (size_t i = 0; i < words.size(); i++)
+      next_word_id = max(next_word_id, word_ids[i] + 1);
+
+  TrieStats &stats = t->root_data_->stats;
+  int num_children = 0;
+  for (int c = 0; c < kNumLetters; c++)
+  {
+    if (root->StartsWord(c))
+    {
+      stats.AddChild(0, num_children++);
+      stats.Merge(group_stats[c]);
+      Trie *child = root->Descend(c);
+      root->NoteWordBelow(child->min_remaining_ + 1);
+      root->NoteWordBelow(child->max_remaining_ + 1);
+    }
+  }
   return t;
 }
@@ -4,8 +4,10 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <array>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -14,6 +16,31 @@ using namespace std;
 const int kNumLetters = 26;
 const int kQ = 'q' - 'a';
 
+// Memory and shape statistics for a Trie. The root is at depth 0.
+struct TrieStats {
+  // Memory used by the nodes. With huge_pages, this is all of the memory that
+  // was mapped for them, including what's left of the last region.
+  size_t bytes = 0;
+  size_t num_nodes = 0;
+  size_t num_words = 0;
+  vector<size_t> nodes_at_depth;
+  vector<size_t> words_at_depth;
+  // child_counts_at_depth[d][k] is the number of nodes at depth d with k children.
+  vector<array<size_t, kNumLetters + 1>> child_counts_at_depth;
+
+  // Average number of children of the nodes that have any.
+  double AverageChildren() const;
+
+  void AddNode(int depth);
+  void AddChild(int depth, int old_num_children);
+  void AddWord(int depth);
+  void Merge(const TrieStats& other);
+};
+
+// State that belongs to a whole Trie rather than to a single node. Only roots
+// carry one, i.e. a Trie made with Trie() or a CreateFrom* method.
+struct TrieRootData;
+
 class Trie {
  public:
   Trie();
@@ -24,19 +51,60 @@ class Trie {
   Trie* Descend(int i) const { return children_[i]; }
 
   bool IsWord() const { return is_word_; }
-  void SetIsWord() { is_word_ = true; }
+  void SetIsWord() {
+    is_word_ = true;
+    min_remaining_ = 0;
+  }
+  // Each word in a Trie has its own id, which solvers that don't write marks
+  // (e.g. ConcurrentBoggler) rely on. AddWord numbers words in the order they're
+  // added, counting from 0. If you use SetWordId, keep the ids distinct.
   void SetWordId(uint32_t word_id) { word_id_ = word_id; }
   uint32_t WordId() const { return word_id_; }
 
   void Mark(uintptr_t m) { mark_ = m; }
   uintptr_t Mark() { return mark_; }
 
+  // The fewest and most letters from this node to a word at or below it (0 if
+  // this is a word), or kNoWordBelow and 0 if there are none. These count
+  // Trie edges, so "qu" is one letter, just as it takes up one cell.
+  static constexpr int kNoWordBelow = 255;
+  int MinRemaining() const { return min_remaining_; }
+  int MaxRemaining() const { return max_remaining_; }
+
   // Trie construction
-  // Returns a pointer to the new Trie node at the end of the word.
+  // Returns a pointer to the new Trie node at the end of the word. Call this on
+  // the root: it's what assigns word ids and keeps Stats() up to date, and it
+  // only updates MinRemaining() and MaxRemaining() from this node down.
   Trie* AddWord(const char* wd);
-  static unique_ptr<Trie> CreateFromFile(const char* filename);
+  // With huge_pages, nodes are packed into regions aligned to 2 MB pages
+  // rather than allocated one at a time, so that a search touches far fewer
+  // TLB entries. This uses reserved huge pages (MAP_HUGETLB) if there are any,
+  // then transparent huge pages, then regular pages; see NodePlacement().
+  static unique_ptr<Trie> CreateFromFile(const char* filename, bool huge_pages = false);
   static unique_ptr<Trie> CreateFromFileStr(const string& filename);
-  static unique_ptr<Trie> CreateFromWordlist(const vector<string>& words);
+  static unique_ptr<Trie> CreateFromWordlist(const vector<string>& words, bool huge_pages = false);
+  // Faster loader for sorted word lists. This mmaps the file, builds nodes in
+  // order into a single block (no per-node allocations) and splits the work
+  // across num_threads threads by first letter (0 = one per core). Falls back
+  // to CreateFromFile if the words aren't sorted.
+  static unique_ptr<Trie> CreateFromFileBulk(
+      const char* filename, int num_threads, bool huge_pages = false
+  );
+  // Builds from sorted, unique Boggle words (still spelled with "qu") the same
+  // way, giving words[i] the id word_ids[i]. Returns NULL on bad input.
+  static unique_ptr<Trie> CreateFromSortedWords(
+      const vector<string>& words, const vector<uint32_t>& word_ids, int num_threads
+  );
+
+  // Roots keep their stats up to date as words are added, so this is cheap and
+  // safe to call from another thread. For any other node, this walks its
+  // subtree.
+  TrieStats Stats() const;
+
+  // Where this root's nodes live: "heap" unless it was created with
+  // huge_pages, otherwise the kinds of pages that were used, "hugetlb", "thp"
+  // or "regular", joined with "+" if there was more than one.
+  string NodePlacement() const;
 
   // Some slower methods that operate on the entire Trie (not just a node).
   size_t Size();
@@ -45,6 +113,8 @@ class Trie {
   void ResetMarks();
   Trie* FindWord(const char* wd);
   Trie* FindWordId(int word_id);
+  // Largest word id of any word in the Trie, or -1 if it has no words.
+  int64_t MaxWordId() const;
 
   static bool ReverseLookup(const Trie* base, const Trie* child, string* out);
   static string ReverseLookup(const Trie* base, const Trie* child);
@@ -55,10 +125,33 @@ class Trie {
   static bool IsBoggleWord(const char* word);
 
  private:
-  bool is_word_;
-  uintptr_t mark_;
+  // For nodes below the root. pooled is set for nodes in memory owned by the
+  // root (see CreateFromFileBulk).
+  explicit Trie(bool pooled);
+  static unique_ptr<Trie> CreateRoot(bool huge_pages = false);
+  // Words must be sorted Boggle words. Ids are indices if word_ids is NULL.
+  static unique_ptr<Trie> BuildFromSortedWords(
+      const vector<string_view>& words,
+      const uint32_t* word_ids,
+      int num_threads,
+      bool huge_pages
+  );
+  int NumChildren() const;
+  // Updates MinRemaining() and MaxRemaining() for a word this far below.
+  void NoteWordBelow(int distance);
+  void AccumulateStats(int depth, TrieStats* stats) const;
+
+  // Fields are ordered to avoid padding.
   Trie* children_[26];
+  uintptr_t mark_;
+  unique_ptr<TrieRootData> root_data_;
   uint32_t word_id_;
+  bool is_word_;
+  // This node lives in memory owned by the root, not its own allocation.
+  bool pooled_;
+  // These fit in what would otherwise be padding.
+  uint8_t min_remaining_;
+  uint8_t max_remaining_;
 };
 
 #endif
@@ -0,0 +1,98 @@
+#include "versioned_trie.h"
+
+#include <stdio.h>
+
+using namespace std;
+
+/* static */ unique_ptr<VersionedTrie> VersionedTrie::CreateFromFile(
+    const char* filename
+) {
+  char line[80];
+  FILE* f = fopen(filename, "r");
+  if (!f) {
+    fprintf(stderr, "Couldn't open %s\n", filename);
+    return NULL;
+  }
+
+  // Word ids match Trie::CreateFromFile.
+  unique_ptr<VersionedTrie> t(new VersionedTrie);
+  lock_guard<mutex> lock(t->writer_mutex_);
+  while (fscanf(f, "%s", line) == 1) {
+    if (Trie::IsBoggleWord(line)) {
+      t->words_[line] = {t->next_word_id_++, true};
+    }
+  }
+  fclose(f);
+  t->num_words_ = t->words_.size();
+  t->Publish();
+  return t;
+}
+
+/* static */ unique_ptr<VersionedTrie> VersionedTrie::CreateFromWordlist(
+    const vector<string>& words
+) {
+  unique_ptr<VersionedTrie> t(new VersionedTrie);
+  t->Update(words, {});
+  return t;
+}
+
+shared_ptr<Trie> VersionedTrie::Snapshot(uint64_t* version) const {
+  lock_guard<mutex> lock(snapshot_mutex_);
+  if (version) *version = version_.load(memory_order_relaxed);
+  return snapshot_;
+}
+
+uint64_t VersionedTrie::Update(
+    const vector<string>& add, const vector<string>& remove
+) {
+  lock_guard<mutex> lock(writer_mutex_);
+  for (const auto& word : add) {
+    if (!Trie::IsBoggleWord(word.c_str())) continue;
+    auto it = words_.find(word);
+    if (it == words_.end()) {
+      words_[word] = {next_word_id_++, true};
+      num_words_++;
+    } else if (!it->second.present) {
+      it->second.present = true;
+      num_words_++;
+    }
+  }
+  for (const auto& word : remove) {
+    auto it = words_.find(word);
+    if (it != words_.end() && it->second.present) {
+      it->second.present = false;
+      num_words_--;
+    }
+  }
+  Publish();
+  return Version();
+}
+
+size_t VersionedTrie::Size() const {
+  lock_guard<mutex> lock(writer_mutex_);
+  return num_words_;
+}
+
+void VersionedTrie::Publish() {
+  vector<string> words;
+  vector<uint32_t> word_ids;
+  words.reserve(num_words_);
+  word_ids.reserve(num_words_);
+  for (const auto& [word, entry] : words_) {
+    if (entry.present) {
+      words.push_back(word);
+      word_ids.push_back(entry.word_id);
+    }
+  }
+
+  // Build on this thread only, so that updates don't compete with scorers.
+  shared_ptr<Trie> snapshot = Trie::CreateFromSortedWords(words, word_ids, 1);
+
+  // The old snapshot is released outside the lock (and freed here if no
+  // scorer still holds it).
+  {
+    lock_guard<mutex> lock(snapshot_mutex_);
+    snapshot.swap(snapshot_);
+    version_.store(version_.load(memory_order_relaxed) + 1, memory_order_release);
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef VERSIONED_TRIE_H__
+#define VERSIONED_TRIE_H__
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "trie.h"
+
+using namespace std;
+
+// A dictionary that can change while boards are being scored against it.
+//
+// Every version is an immutable Trie snapshot. Writers apply batches of
+// additions and removals to a master word list and publish a freshly built
+// snapshot in one step. Scorers keep the snapshot they hold until they choose
+// to pick up a new one (see LiveBoggler), so an update never blocks a search
+// in progress. Each snapshot is freed when the last scorer holding it lets go.
+//
+// Snapshots are shared, so they must only be scored with something that
+// doesn't write marks into the Trie, like LiveBoggler or ConcurrentBoggler.
+class VersionedTrie {
+ public:
+  static unique_ptr<VersionedTrie> CreateFromFile(const char* filename);
+  static unique_ptr<VersionedTrie> CreateFromWordlist(const vector<string>& words);
+
+  // The latest published version. This is a single atomic load, so scorers
+  // can poll it before every board.
+  uint64_t Version() const { return version_.load(memory_order_acquire); }
+
+  // Returns the latest snapshot and optionally its version. Holding on to the
+  // snapshot keeps it alive after newer versions are published.
+  shared_ptr<Trie> Snapshot(uint64_t* version = NULL) const;
+
+  // Adds and removes a batch of words and publishes the result as a new
+  // version, which is returned. A word in both lists ends up removed. Words
+  // that can't appear on a Boggle board are ignored. Words keep their ids
+  // across versions, even if they're removed and added back.
+  uint64_t Update(const vector<string>& add, const vector<string>& remove);
+
+  // Number of words in the latest version.
+  size_t Size() const;
+
+ private:
+  struct Entry {
+    uint32_t word_id;
+    bool present;
+  };
+
+  VersionedTrie() : num_words_(0), next_word_id_(0), version_(0) {}
+  // Builds and publishes a snapshot of words_. Requires writer_mutex_.
+  void Publish();
+
+  // Serializes writers and guards the fields below it.
+  mutable mutex writer_mutex_;
+  // Every word ever added, spelled with "qu". This is sorted, which is what
+  // Trie::CreateFromSortedWords needs.
+  map<string, Entry> words_;
+  size_t num_words_;
+  uint32_t next_word_id_;
+
+  // Guards snapshot_. This is only held long enough to copy the pointer.
+  mutable mutex snapshot_mutex_;
+  shared_ptr<Trie> snapshot_;
+  atomic<uint64_t> version_;
+};
+
+#endif
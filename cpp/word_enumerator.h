@@ -0,0 +1,114 @@
+// Lazily lists the words on an MxN board.
+#ifndef WORD_ENUMERATOR_H
+#define WORD_ENUMERATOR_H
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "boggler.h"
+#include "constants.h"
+#include "generator.h"
+#include "neighbors.h"
+#include "trie.h"
+
+using namespace std;
+
+struct FoundWord {
+  uint32_t word_id;
+  vector<int> path;  // cells, in order
+};
+
+// Boggler::FindWords finds every path before returning any of them. Words()
+// yields them one at a time instead, so a caller that only needs the first few
+// words, or stops once it's seen a particular one, doesn't pay for the rest
+// of the search: destroying the Generator stops it.
+//
+//   WordEnumerator<4, 4> e(trie);
+//   for (const FoundWord& w : e.Words("perslatgsineters", 5, {})) {
+//     if (w.word_id == wanted) break;
+//   }
+//
+// Each search keeps all its state in its coroutine, so a WordEnumerator can
+// run any number of them at once. It doesn't write to the Trie, either.
+template <int M, int N>
+class WordEnumerator {
+ public:
+  WordEnumerator(const Trie* t) : dict_(t) {}
+
+  // Yields each word on the board with at least min_length letters ("Qu"
+  // counts as two), with the same path and in the same order as
+  // Boggler::FindWords. If word_ids isn't empty, only those words are yielded.
+  // Yields nothing for an invalid board.
+  Generator<FoundWord> Words(string lets, int min_length, unordered_set<uint32_t> word_ids) const;
+
+  unsigned int NumCells() { return M * N; }
+
+ private:
+  const Trie* dict_;
+};
+
+// The search is the same as IterativeBoggler's, with an explicit stack, so the
+// coroutine can suspend in the middle of it. Note that the arguments are taken
+// by value: the coroutine outlives this call.
+template <int M, int N>
+Generator<FoundWord> WordEnumerator<M, N>::Words(
+    string lets, int min_length, unordered_set<uint32_t> word_ids
+) const {
+  int bd[M * N];
+  if (!ParseBoardString(lets.c_str(), bd, M * N)) co_return;
+
+  struct Frame {
+    const Trie* t;
+    int cell;
+    int len;   // with "Qu" counting as two letters
+    int next;  // index into Neighbors<M, N>::NEIGHBORS[cell] to try next
+  };
+  Frame stack[M * N];
+  int depth = 0;
+  int next_start = 0;
+  unsigned int used = 0;
+  unordered_set<uint32_t> found;
+
+  while (true) {
+    int i, len;
+    const Trie* t;
+    if (depth == 0) {
+      if (next_start == M * N) break;
+      i = next_start++;
+      if (bd[i] == -1 || !dict_->StartsWord(bd[i])) continue;
+      len = 0;
+      t = dict_->Descend(bd[i]);
+    } else {
+      Frame& f = stack[depth - 1];
+      const auto& neighbors = Neighbors<M, N>::NEIGHBORS[f.cell];
+      if (f.next > neighbors[0]) {
+        used ^= (1 << f.cell);
+        depth--;
+        continue;
+      }
+      i = neighbors[f.next++];
+      int cc = bd[i];
+      if ((used & (1 << i)) || cc == -1 || !f.t->StartsWord(cc)) continue;
+      len = f.len;
+      t = f.t->Descend(cc);
+    }
+
+    used ^= (1 << i);
+    len += (bd[i] == kQ ? 2 : 1);
+    stack[depth++] = {t, i, len, 1};
+    if (t->IsWord() && len >= min_length) {
+      uint32_t word_id = t->WordId();
+      if ((word_ids.empty() || word_ids.count(word_id)) && found.insert(word_id).second) {
+        FoundWord w{word_id, {}};
+        w.path.reserve(depth);
+        for (int d = 0; d < depth; d++) w.path.push_back(stack[d].cell);
+        co_yield move(w);
+      }
+    }
+  }
+}
+
+#endif  // WORD_ENUMERATOR_H